@@ -0,0 +1,161 @@
+#include "bufferpool.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef Q_OS_WIN
+#include <malloc.h>
+#endif
+
+namespace {
+qint64 alignedBufferSize(qint64 requested, qint64 capacity) {
+    qint64 size = std::max<qint64>(requested, BufferPool::Alignment);
+    if (capacity > 0) {
+        size = std::min(size, std::max<qint64>(capacity, BufferPool::Alignment));
+    }
+    return (size / BufferPool::Alignment) * BufferPool::Alignment;
+}
+
+char *allocateAligned(qint64 size) {
+#ifdef Q_OS_WIN
+    return static_cast<char *>(_aligned_malloc(static_cast<size_t>(size), BufferPool::Alignment));
+#else
+    void *memory = nullptr;
+    if (posix_memalign(&memory, BufferPool::Alignment, static_cast<size_t>(size)) != 0) {
+        return nullptr;
+    }
+    return static_cast<char *>(memory);
+#endif
+}
+
+void freeAligned(char *buffer) {
+#ifdef Q_OS_WIN
+    _aligned_free(buffer);
+#else
+    std::free(buffer);
+#endif
+}
+}
+
+BufferPool::Lease::Lease(BufferPool *pool, char *data, qint64 size)
+    : m_pool(pool),
+      m_data(data),
+      m_size(size) {
+}
+
+BufferPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(other.m_pool),
+      m_data(other.m_data),
+      m_size(other.m_size) {
+    other.m_pool = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+BufferPool::Lease &BufferPool::Lease::operator=(Lease &&other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(m_pool, other.m_pool);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+    return *this;
+}
+
+BufferPool::Lease::~Lease() {
+    release();
+}
+
+void BufferPool::Lease::release() {
+    if (m_pool && m_data) {
+        m_pool->giveBack(m_data);
+    }
+    m_pool = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+BufferPool::BufferPool(qint64 bufferSize, qint64 capacityBytes)
+    : m_bufferSize(alignedBufferSize(bufferSize, capacityBytes)),
+      m_bufferCount(static_cast<int>(std::max<qint64>(1, capacityBytes / alignedBufferSize(bufferSize, capacityBytes)))) {
+    m_free.reserve(static_cast<size_t>(m_bufferCount));
+    m_allocated.reserve(static_cast<size_t>(m_bufferCount));
+}
+
+BufferPool::~BufferPool() {
+    for (char *buffer : m_allocated) {
+        freeAligned(buffer);
+    }
+}
+
+BufferPool::Lease BufferPool::acquire() {
+    QMutexLocker locker(&m_mutex);
+    char *data = nullptr;
+    bool waited = false;
+    while (!(data = takeLocked())) {
+        if (m_inUse == 0) {
+            // Nenhum buffer será devolvido: a alocação falhou por falta de memória.
+            return Lease();
+        }
+        if (!waited) {
+            ++m_waits;
+            waited = true;
+        }
+        m_available.wait(&m_mutex);
+    }
+    return Lease(this, data, m_bufferSize);
+}
+
+BufferPool::Lease BufferPool::tryAcquire() {
+    QMutexLocker locker(&m_mutex);
+    char *data = takeLocked();
+    return data ? Lease(this, data, m_bufferSize) : Lease();
+}
+
+qint64 BufferPool::peakBytesInUse() const {
+    QMutexLocker locker(&m_mutex);
+    return m_bufferSize * m_peakInUse;
+}
+
+qint64 BufferPool::allocatedBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_bufferSize * static_cast<qint64>(m_allocated.size());
+}
+
+qint64 BufferPool::waitCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_waits;
+}
+
+// Buffers são alocados sob demanda até o limite e depois apenas reciclados,
+// de modo que o alocador só aparece nas primeiras requisições.
+char *BufferPool::takeLocked() {
+    char *data = nullptr;
+    if (!m_free.empty()) {
+        data = m_free.back();
+        m_free.pop_back();
+    } else if (static_cast<int>(m_allocated.size()) < m_bufferCount) {
+        data = allocateAligned(m_bufferSize);
+        if (!data) {
+            return nullptr;
+        }
+        m_allocated.push_back(data);
+    } else {
+        return nullptr;
+    }
+
+    ++m_inUse;
+    m_peakInUse = std::max(m_peakInUse, m_inUse);
+    return data;
+}
+
+void BufferPool::giveBack(char *data) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_free.push_back(data);
+        --m_inUse;
+    }
+    m_available.wakeOne();
+}
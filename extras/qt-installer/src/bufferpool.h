@@ -0,0 +1,73 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+#include <vector>
+
+// Conjunto fixo de buffers alinhados compartilhado pelas etapas de cópia,
+// verificação e descompressão. O consumo de memória nunca ultrapassa o
+// limite configurado: quando todos os buffers estão em uso, acquire()
+// bloqueia até que outra etapa devolva um (contrapressão).
+class BufferPool {
+public:
+    static constexpr qint64 Alignment = 4096;
+
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        char *data() const { return m_data; }
+        qint64 size() const { return m_size; }
+        bool isValid() const { return m_data != nullptr; }
+        void release();
+
+    private:
+        friend class BufferPool;
+        Lease(BufferPool *pool, char *data, qint64 size);
+
+        BufferPool *m_pool = nullptr;
+        char *m_data = nullptr;
+        qint64 m_size = 0;
+    };
+
+    BufferPool(qint64 bufferSize, qint64 capacityBytes);
+    ~BufferPool();
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    Lease acquire();
+    Lease tryAcquire();
+
+    qint64 bufferSize() const { return m_bufferSize; }
+    int bufferCount() const { return m_bufferCount; }
+    qint64 capacityBytes() const { return m_bufferSize * m_bufferCount; }
+    qint64 peakBytesInUse() const;
+    qint64 allocatedBytes() const;
+    qint64 waitCount() const;
+
+private:
+    char *takeLocked();
+    void giveBack(char *data);
+
+    const qint64 m_bufferSize;
+    const int m_bufferCount;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_available;
+    std::vector<char *> m_free;
+    std::vector<char *> m_allocated;
+    int m_inUse = 0;
+    int m_peakInUse = 0;
+    qint64 m_waits = 0;
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,272 @@
+#include "embeddedpayload.h"
+#include "payloadtree.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr qint64 kPackChunkSize = 8 * 1024 * 1024;
+
+bool padTo(QFile &file, qint64 alignment) {
+    const qint64 padding = (alignment - file.pos() % alignment) % alignment;
+    return padding == 0 || file.write(QByteArray(static_cast<int>(padding), '\0')) == padding;
+}
+
+bool appendFile(QFile &output, const QString &sourcePath, qint64 &size) {
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    size = 0;
+    while (!source.atEnd()) {
+        const QByteArray chunk = source.read(kPackChunkSize);
+        if (chunk.isEmpty() || output.write(chunk) != chunk.size()) {
+            return false;
+        }
+        size += chunk.size();
+    }
+    return true;
+}
+}
+
+EmbeddedPayload::~EmbeddedPayload() {
+    unload();
+}
+
+bool EmbeddedPayload::probe(const QString &executablePath) {
+    unload();
+    m_file.close();
+    m_dataStart = m_dataSize = m_indexOffset = m_indexSize = 0;
+
+    m_file.setFileName(executablePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < FooterSize || !m_file.seek(fileSize - FooterSize)) {
+        m_file.close();
+        return false;
+    }
+
+    const QByteArray footer = m_file.read(FooterSize);
+    if (footer.size() != FooterSize || std::memcmp(footer.constData(), Magic, 8) != 0) {
+        m_file.close();
+        return false;
+    }
+
+    QDataStream stream(footer);
+    stream.skipRawData(8);
+    quint64 dataStart = 0;
+    quint64 indexOffset = 0;
+    quint64 indexSize = 0;
+    stream >> dataStart >> indexOffset >> indexSize;
+
+    const quint64 footerOffset = static_cast<quint64>(fileSize - FooterSize);
+    if (stream.status() != QDataStream::Ok || dataStart > indexOffset || indexOffset + indexSize != footerOffset) {
+        m_file.close();
+        return false;
+    }
+
+    m_dataStart = static_cast<qint64>(dataStart);
+    m_dataSize = static_cast<qint64>(indexOffset - dataStart);
+    m_indexOffset = static_cast<qint64>(indexOffset);
+    m_indexSize = static_cast<qint64>(indexSize);
+    return true;
+}
+
+bool EmbeddedPayload::load(PayloadTree &tree, QString &error) {
+    if (!isPresent()) {
+        error = tr("O executável não contém um pacote embutido.");
+        return false;
+    }
+
+    if (!m_map) {
+        m_map = m_file.map(m_dataStart, m_dataSize + m_indexSize);
+        if (!m_map) {
+            error = tr("Não foi possível mapear o pacote embutido: %1").arg(m_file.errorString());
+            return false;
+        }
+    }
+
+    const QByteArray index = QByteArray::fromRawData(reinterpret_cast<const char *>(m_map + m_dataSize), m_indexSize);
+    QDataStream stream(index);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 version = 0;
+    stream >> version;
+    if (version != FormatVersion) {
+        error = tr("Versão de pacote embutido não suportada: %1").arg(version);
+        return false;
+    }
+
+    tree.clear();
+
+    quint32 directoryCount = 0;
+    stream >> directoryCount;
+    for (quint32 entry = 0; entry < directoryCount && stream.status() == QDataStream::Ok; ++entry) {
+        qint32 parent = 0;
+        QByteArray name;
+        stream >> parent >> name;
+        // Diretórios vêm sempre depois do pai; o índice 0 é a raiz.
+        if (parent < 0 || static_cast<size_t>(parent) >= tree.directories().size()) {
+            error = tr("Índice do pacote embutido corrompido.");
+            return false;
+        }
+        tree.addDirectory(parent, name.constData());
+    }
+
+    quint32 fileCount = 0;
+    stream >> fileCount;
+    for (quint32 entry = 0; entry < fileCount && stream.status() == QDataStream::Ok; ++entry) {
+        qint32 directory = 0;
+        QByteArray name;
+        quint64 offset = 0;
+        quint64 size = 0;
+        quint32 mode = 0;
+        stream >> directory >> name >> offset >> size >> mode;
+        if (directory < 0 || static_cast<size_t>(directory) >= tree.directories().size()
+            || offset + size > static_cast<quint64>(m_dataSize)) {
+            error = tr("Índice do pacote embutido corrompido.");
+            return false;
+        }
+        PayloadTree::File &file = tree.addFile(directory, name.constData());
+        file.dataOffset = offset;
+        file.size = static_cast<qint64>(size);
+        file.mode = mode;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        error = tr("Índice do pacote embutido corrompido.");
+        return false;
+    }
+    return true;
+}
+
+bool EmbeddedPayload::pack(const QString &executablePath, const QString &payloadDirectory, const QString &outputPath, QString &error) {
+    QFile::remove(outputPath);
+    if (!QFile::copy(executablePath, outputPath)) {
+        error = tr("Não foi possível copiar %1 para %2").arg(executablePath, outputPath);
+        return false;
+    }
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::ReadWrite) || !output.seek(output.size()) || !padTo(output, Alignment)) {
+        error = tr("Não foi possível gravar %1: %2").arg(outputPath, output.errorString());
+        return false;
+    }
+    const qint64 dataStart = output.pos();
+
+    QByteArray index;
+    QDataStream stream(&index, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    // Diretórios são listados em largura, sempre depois do pai, e os arquivos
+    // de cada diretório em ordem alfabética para que o pacote seja reprodutível.
+    std::vector<std::pair<int, QString>> pending{{0, payloadDirectory}};
+    QByteArray directories;
+    QDataStream directoryStream(&directories, QIODevice::WriteOnly);
+    directoryStream.setVersion(QDataStream::Qt_6_0);
+    QByteArray files;
+    QDataStream fileStream(&files, QIODevice::WriteOnly);
+    fileStream.setVersion(QDataStream::Qt_6_0);
+    quint32 directoryCount = 0;
+    quint32 fileCount = 0;
+
+    for (size_t next = 0; next < pending.size(); ++next) {
+        const int directory = pending[next].first;
+        const QDir dir(pending[next].second);
+        const QFileInfoList entries = dir.entryInfoList(QDir::Dirs | QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDir::Name);
+        for (const QFileInfo &entry : entries) {
+            const QByteArray name = QFile::encodeName(entry.fileName());
+            if (entry.isDir()) {
+                ++directoryCount;
+                directoryStream << static_cast<qint32>(directory) << name;
+                // Como no inventário do Linux, diretórios apontados por links são criados, mas não percorridos.
+                if (!entry.isSymLink()) {
+                    pending.emplace_back(static_cast<int>(directoryCount), entry.absoluteFilePath());
+                }
+                continue;
+            }
+            if (!entry.isFile()) {
+                continue;
+            }
+
+            // Só arquivos a partir de uma página são alinhados; alinhar os
+            // pequenos multiplicaria o tamanho de pacotes como node_modules.
+            qint64 size = 0;
+            if (entry.size() >= Alignment && !padTo(output, Alignment)) {
+                error = tr("Não foi possível gravar %1: %2").arg(outputPath, output.errorString());
+                return false;
+            }
+            const qint64 offset = output.pos() - dataStart;
+            if (!appendFile(output, entry.absoluteFilePath(), size)) {
+                error = tr("Falha ao anexar %1: %2").arg(entry.absoluteFilePath(), output.errorString());
+                return false;
+            }
+            ++fileCount;
+            fileStream << static_cast<qint32>(directory) << name << static_cast<quint64>(offset)
+                       << static_cast<quint64>(size) << modeFromPermissions(entry.permissions());
+        }
+    }
+
+    stream << FormatVersion << directoryCount;
+    stream.writeRawData(directories.constData(), directories.size());
+    stream << fileCount;
+    stream.writeRawData(files.constData(), files.size());
+
+    const qint64 indexOffset = output.pos();
+    QByteArray footer;
+    QDataStream footerStream(&footer, QIODevice::WriteOnly);
+    footerStream.writeRawData(Magic, 8);
+    footerStream << static_cast<quint64>(dataStart) << static_cast<quint64>(indexOffset) << static_cast<quint64>(index.size());
+
+    if (output.write(index) != index.size() || output.write(footer) != FooterSize) {
+        error = tr("Não foi possível gravar %1: %2").arg(outputPath, output.errorString());
+        return false;
+    }
+    output.close();
+    output.setPermissions(output.permissions() | QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup | QFileDevice::ExeOther);
+    return true;
+}
+
+void EmbeddedPayload::unload() {
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+}
+
+quint32 EmbeddedPayload::modeFromPermissions(QFileDevice::Permissions permissions) {
+    quint32 mode = 0;
+    if (permissions & QFileDevice::ReadOwner) mode |= 0400;
+    if (permissions & QFileDevice::WriteOwner) mode |= 0200;
+    if (permissions & QFileDevice::ExeOwner) mode |= 0100;
+    if (permissions & QFileDevice::ReadGroup) mode |= 0040;
+    if (permissions & QFileDevice::WriteGroup) mode |= 0020;
+    if (permissions & QFileDevice::ExeGroup) mode |= 0010;
+    if (permissions & QFileDevice::ReadOther) mode |= 0004;
+    if (permissions & QFileDevice::WriteOther) mode |= 0002;
+    if (permissions & QFileDevice::ExeOther) mode |= 0001;
+    return mode;
+}
+
+QFileDevice::Permissions EmbeddedPayload::permissionsFromMode(quint32 mode) {
+    QFileDevice::Permissions permissions;
+    if (mode & 0400) permissions |= QFileDevice::ReadOwner | QFileDevice::ReadUser;
+    if (mode & 0200) permissions |= QFileDevice::WriteOwner | QFileDevice::WriteUser;
+    if (mode & 0100) permissions |= QFileDevice::ExeOwner | QFileDevice::ExeUser;
+    if (mode & 0040) permissions |= QFileDevice::ReadGroup;
+    if (mode & 0020) permissions |= QFileDevice::WriteGroup;
+    if (mode & 0010) permissions |= QFileDevice::ExeGroup;
+    if (mode & 0004) permissions |= QFileDevice::ReadOther;
+    if (mode & 0002) permissions |= QFileDevice::WriteOther;
+    if (mode & 0001) permissions |= QFileDevice::ExeOther;
+    return permissions;
+}
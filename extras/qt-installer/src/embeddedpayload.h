@@ -0,0 +1,61 @@
+#ifndef EMBEDDEDPAYLOAD_H
+#define EMBEDDEDPAYLOAD_H
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QString>
+
+class PayloadTree;
+
+// Pacote anexado ao próprio executável pelo anything-llm-payload-packer.
+//
+// Layout, a partir do fim do executável original:
+//   [dados dos arquivos; os maiores que uma página começam alinhados a Alignment]
+//   [índice: diretórios e arquivos serializados com QDataStream]
+//   [rodapé: Magic, início dos dados, posição e tamanho do índice]
+//
+// probe() lê apenas o rodapé. O índice só é interpretado em load(), quando a
+// instalação começa, e os dados são copiados direto do mapeamento do arquivo.
+class EmbeddedPayload {
+    Q_DECLARE_TR_FUNCTIONS(EmbeddedPayload)
+public:
+    static constexpr char Magic[9] = "ALLMPAK1";
+    static constexpr qint64 Alignment = 4096;
+    static constexpr qint64 FooterSize = 32;
+    static constexpr quint32 FormatVersion = 1;
+
+    EmbeddedPayload() = default;
+    ~EmbeddedPayload();
+
+    EmbeddedPayload(const EmbeddedPayload &) = delete;
+    EmbeddedPayload &operator=(const EmbeddedPayload &) = delete;
+
+    bool probe(const QString &executablePath);
+    bool isPresent() const { return m_dataSize > 0 || m_indexSize > 0; }
+    QString executablePath() const { return m_file.fileName(); }
+
+    bool load(PayloadTree &tree, QString &error);
+    void unload();
+
+    // Início dos dados mapeados; File::dataOffset é relativo a este ponteiro.
+    const uchar *data() const { return m_map; }
+    qint64 dataSize() const { return m_dataSize; }
+
+    // Gera outputPath com o executável seguido do conteúdo de payloadDirectory.
+    // Usado pelo anything-llm-payload-packer durante o build.
+    static bool pack(const QString &executablePath, const QString &payloadDirectory, const QString &outputPath, QString &error);
+
+    // Modos de arquivo são gravados no formato Unix (0755 etc.).
+    static quint32 modeFromPermissions(QFileDevice::Permissions permissions);
+    static QFileDevice::Permissions permissionsFromMode(quint32 mode);
+
+private:
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_dataStart = 0;
+    qint64 m_dataSize = 0;
+    qint64 m_indexOffset = 0;
+    qint64 m_indexSize = 0;
+};
+
+#endif // EMBEDDEDPAYLOAD_H
@@ -1,4 +1,8 @@
 #include "installerlogic.h"
+#include "bufferpool.h"
+#include "embeddedpayload.h"
+#include "payloadtree.h"
+#include "postinstallgraph.h"
 
 #include <QCoreApplication>
 #include <QDateTime>
@@ -6,9 +10,11 @@
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLatin1String>
+#include <QSet>
 #include <QtGlobal>
 #include <QProcess>
 #include <QStandardPaths>
@@ -17,20 +23,273 @@
 
 #include <algorithm>
 
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace {
+// Intervalo mínimo entre mensagens "Copiado ..." no log; com dezenas de
+// milhares de arquivos pequenos o log e os sinais passam a dominar a cópia.
+constexpr qint64 kFileMessageIntervalMs = 100;
+
+// Nas ordens por localidade, os arquivos são lidos em lotes: o kernel recebe
+// de uma vez as leituras antecipadas do lote, já ordenadas pela posição.
+constexpr int kReadBatchFiles = 64;
+constexpr qint64 kReadBatchBytesPerFile = 2 * 1024 * 1024;
+
+// Bloco de leitura dos arquivos recopiados pelo reparo incremental.
+constexpr qint64 kRepairChunkSize = 1024 * 1024;
+
+// Folga na comparação de datas de modificação com o registro da instalação:
+// FAT e exFAT gravam a data em passos de 2 s.
+constexpr qint64 kModificationToleranceMs = 2000;
+
+// Cada destino e a origem mantêm um cache de pastas abertas. O orçamento de
+// descritores é dividido entre eles, descontada uma reserva para o Qt, o log
+// e a cópia; abaixo do mínimo, a cópia recusa os destinos antes de começar.
+constexpr int kDirectoryHandlesPerCache = 128;
+constexpr int kMinDirectoryHandlesPerCache = 16;
+constexpr qint64 kReservedDescriptors = 64;
+
+QString copyOrderKey(InstallerLogic::CopyOrder order) {
+    switch (order) {
+    case InstallerLogic::CopyOrder::InodeOrder:
+        return QStringLiteral("inode");
+    case InstallerLogic::CopyOrder::PhysicalOrder:
+        return QStringLiteral("physical");
+    case InstallerLogic::CopyOrder::DirectoryOrder:
+        break;
+    }
+    return QStringLiteral("directory");
+}
+
+QString describeAction(InstallerLogic::InstallAction action) {
+    switch (action) {
+    case InstallerLogic::InstallAction::UpdateExisting:
+        return InstallerLogic::tr("atualização da instalação existente");
+    case InstallerLogic::InstallAction::RepairExisting:
+        return InstallerLogic::tr("reparo da instalação existente");
+    case InstallerLogic::InstallAction::FreshInstall:
+        break;
+    }
+    return InstallerLogic::tr("nova instalação");
+}
+
+#ifdef Q_OS_LINUX
+// Eleva o limite flexível de arquivos abertos até o rígido e devolve o limite
+// em vigor; o padrão de 1024 não comporta muitos destinos.
+qint64 raiseOpenFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return 1024;
+    }
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < limit.rlim_max) {
+        struct rlimit raised = limit;
+        raised.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+            limit = raised;
+        }
+    }
+    if (limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > static_cast<rlim_t>(INT_MAX)) {
+        return INT_MAX;
+    }
+    return static_cast<qint64>(limit.rlim_cur);
+}
+
+// Descritores fora dos caches de pastas: a raiz e o arquivo aberto de cada
+// destino, a raiz e o arquivo da origem e o lote de leitura antecipada.
+qint64 fixedDescriptors(qint64 targetCount) {
+    return kReservedDescriptors + kReadBatchFiles + 2 + 2 * targetCount;
+}
+#endif
+
 QString sanitizePath(QString path) {
     QDir dir(path);
     return dir.absolutePath();
 }
+
+QString describeLargeFileCopy(const QString &relativePath, const LargeFileCopier::Stats &stats) {
+    const double mebibyte = 1024.0 * 1024.0;
+    QString details = InstallerLogic::tr("%1 MiB em %2 s, %3 MiB/s")
+                          .arg(static_cast<double>(stats.logicalSize) / mebibyte, 0, 'f', 1)
+                          .arg(static_cast<double>(stats.elapsedMs) / 1000.0, 0, 'f', 2)
+                          .arg(stats.throughputMiBps(), 0, 'f', 1);
+    if (stats.holeBytes > 0) {
+        details += InstallerLogic::tr(", %1 MiB esparsos preservados").arg(static_cast<double>(stats.holeBytes) / mebibyte, 0, 'f', 1);
+    }
+    if (stats.clonedDestinations > 0) {
+        details += InstallerLogic::tr(", reflink em %1 destino(s)").arg(stats.clonedDestinations);
+    }
+    if (stats.kernelCopy) {
+        details += InstallerLogic::tr(", copy_file_range");
+    }
+    if (stats.directIoUsed) {
+        details += InstallerLogic::tr(", O_DIRECT");
+    }
+    return InstallerLogic::tr("Arquivo grande %1 (%2)").arg(relativePath, details);
+}
+
+#ifdef Q_OS_LINUX
+QString systemError() {
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+// Cria o arquivo de destino; se já existir, remove-o antes (como fazia o
+// QFile::remove), o que também permite substituir binários em execução.
+int openDestinationFile(int directoryFd, const char *name) {
+    const int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+    int fd = openat(directoryFd, name, flags, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        unlinkat(directoryFd, name, 0);
+        fd = openat(directoryFd, name, flags, 0600);
+    }
+    return fd;
+}
+
+// Endereço físico do primeiro extent do arquivo, ou 0 quando o sistema de
+// arquivos não suporta FIEMAP (NFS, SMB, FUSE) ou o arquivo está vazio.
+quint64 firstPhysicalOffset(int fd) {
+    alignas(struct fiemap) char request[sizeof(struct fiemap) + sizeof(struct fiemap_extent)];
+    std::memset(request, 0, sizeof(request));
+    auto *map = reinterpret_cast<struct fiemap *>(request);
+    map->fm_start = 0;
+    map->fm_length = FIEMAP_MAX_OFFSET;
+    map->fm_extent_count = 1;
+    if (ioctl(fd, FS_IOC_FIEMAP, map) != 0 || map->fm_mapped_extents == 0) {
+        return 0;
+    }
+    return map->fm_extents[0].fe_physical;
+}
+
+bool writeFully(int fd, const char *data, qint64 length) {
+    while (length > 0) {
+        const ssize_t written = ::write(fd, data, static_cast<size_t>(length));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
 }
 
+// Copia dentro do kernel com copy_file_range e, se o sistema de arquivos não
+// permitir, por leitura/escrita com um buffer emprestado do pool.
+bool copyFileContents(int sourceFd, int destinationFd, qint64 size, BufferPool *pool) {
+    qint64 remaining = size;
+    while (remaining > 0) {
+        const ssize_t copied = copy_file_range(sourceFd, nullptr, destinationFd, nullptr, static_cast<size_t>(remaining), 0);
+        if (copied > 0) {
+            remaining -= copied;
+            continue;
+        }
+        if (copied == 0) {
+            return true;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) {
+            break;
+        }
+        return false;
+    }
+    if (remaining == 0) {
+        return true;
+    }
+
+    // copy_file_range avança os offsets dos descritores; continuamos de onde parou.
+    const BufferPool::Lease buffer = pool->acquire();
+    if (!buffer.isValid()) {
+        errno = ENOMEM;
+        return false;
+    }
+    for (;;) {
+        const ssize_t read = ::read(sourceFd, buffer.data(), static_cast<size_t>(buffer.size()));
+        if (read == 0) {
+            return true;
+        }
+        if (read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (!writeFully(destinationFd, buffer.data(), read)) {
+            return false;
+        }
+    }
+}
+
+// Lê a origem uma vez e grava cada bloco em todos os destinos ainda ativos.
+// Retorna false apenas em falhas de leitura; erros de escrita ficam no destino.
+bool fanOutContents(int sourceFd, LargeFileCopier::Destination *destinations, int count, BufferPool *pool) {
+    const BufferPool::Lease buffer = pool->acquire();
+    if (!buffer.isValid()) {
+        errno = ENOMEM;
+        return false;
+    }
+    for (;;) {
+        const ssize_t read = ::read(sourceFd, buffer.data(), static_cast<size_t>(buffer.size()));
+        if (read == 0) {
+            return true;
+        }
+        if (read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        for (int index = 0; index < count; ++index) {
+            LargeFileCopier::Destination &destination = destinations[index];
+            if (!destination.failed() && !writeFully(destination.fd, buffer.data(), read)) {
+                destination.error = systemError();
+            }
+        }
+    }
+}
+#endif
+}
+
+struct InstallerLogic::CopyTarget {
+    QString path;
+    InstallerLogic::InstallAction action = InstallerLogic::InstallAction::FreshInstall;
+    // Preenchido na primeira falha; o destino deixa de receber arquivos.
+    QString error;
+    qint64 copiedFiles = 0;
+    int reportedPercent = -1;
+#ifdef Q_OS_LINUX
+    int rootFd = -1;
+    std::unique_ptr<DirectoryHandleCache> directories;
+#endif
+
+    bool failed() const { return !error.isEmpty(); }
+};
+
 InstallerLogic::InstallerLogic(QObject *parent)
     : QObject(parent),
-      m_availableVersion(QStringLiteral(APP_VERSION)) {
+      m_availableVersion(QStringLiteral(APP_VERSION)),
+      m_embeddedPayload(std::make_unique<EmbeddedPayload>()) {
     qRegisterMetaType<InstallerLogic::InstallationStatus>("InstallerLogic::InstallationStatus");
     qRegisterMetaType<InstallerLogic::InstallResult>("InstallerLogic::InstallResult");
+    // Lê apenas o rodapé do executável; o índice fica para o início da cópia.
+    m_embeddedPayload->probe(QCoreApplication::applicationFilePath());
 }
 
+InstallerLogic::~InstallerLogic() = default;
+
 void InstallerLogic::startDetection() {
     QtConcurrent::run([this]() {
         InstallationStatus status = detectInstallation();
@@ -42,9 +301,25 @@ void InstallerLogic::startInstallation(const QString &targetPath,
                                        InstallAction action,
                                        bool createDesktopShortcut,
                                        bool createMenuShortcut) {
-    const QString sanitizedPath = sanitizePath(targetPath);
-    QtConcurrent::run([this, sanitizedPath, action, createDesktopShortcut, createMenuShortcut]() {
-        InstallResult result = performInstallation(sanitizedPath, action, createDesktopShortcut, createMenuShortcut);
+    startInstallation(QStringList{targetPath}, action, createDesktopShortcut, createMenuShortcut);
+}
+
+void InstallerLogic::startInstallation(const QStringList &targetPaths,
+                                       InstallAction action,
+                                       bool createDesktopShortcut,
+                                       bool createMenuShortcut) {
+    QStringList sanitizedPaths;
+    for (const QString &targetPath : targetPaths) {
+        if (targetPath.trimmed().isEmpty()) {
+            continue;
+        }
+        const QString sanitizedPath = sanitizePath(targetPath);
+        if (!sanitizedPaths.contains(sanitizedPath)) {
+            sanitizedPaths.append(sanitizedPath);
+        }
+    }
+    QtConcurrent::run([this, sanitizedPaths, action, createDesktopShortcut, createMenuShortcut]() {
+        InstallResult result = performInstallation(sanitizedPaths, action, createDesktopShortcut, createMenuShortcut);
         emit installationFinished(result);
     });
 }
@@ -71,6 +346,14 @@ QString InstallerLogic::availableVersion() const {
     return m_availableVersion;
 }
 
+void InstallerLogic::setCopyOptions(const CopyOptions &options) {
+    m_copyOptions = options;
+}
+
+InstallerLogic::CopyOptions InstallerLogic::copyOptions() const {
+    return m_copyOptions;
+}
+
 InstallerLogic::InstallationStatus InstallerLogic::detectInstallation() const {
     InstallationStatus status;
     status.availableVersion = m_availableVersion;
@@ -82,11 +365,19 @@ InstallerLogic::InstallationStatus InstallerLogic::detectInstallation() const {
         const QJsonObject obj = doc.object();
         status.installPath = obj.value(QStringLiteral("path")).toString(status.installPath);
         status.installedVersion = obj.value(QStringLiteral("version")).toString();
+        for (const QJsonValue &target : obj.value(QStringLiteral("targets")).toArray()) {
+            if (!target.toString().isEmpty()) {
+                status.installedTargets.append(sanitizePath(target.toString()));
+            }
+        }
         stateFile.close();
     }
 
     if (!status.installPath.isEmpty()) {
         status.installPath = sanitizePath(status.installPath);
+        if (!status.installedVersion.isEmpty() && !status.installedTargets.contains(status.installPath)) {
+            status.installedTargets.prepend(status.installPath);
+        }
     }
 
     if (!status.installedVersion.isEmpty()) {
@@ -113,40 +404,139 @@ InstallerLogic::InstallationStatus InstallerLogic::detectInstallation() const {
     return status;
 }
 
-InstallerLogic::InstallResult InstallerLogic::performInstallation(const QString &targetPath,
+InstallerLogic::InstallResult InstallerLogic::performInstallation(const QStringList &targetPaths,
                                                                   InstallAction action,
                                                                   bool createDesktopShortcut,
                                                                   bool createMenuShortcut) {
     InstallResult result;
     QString error;
 
-    emit installationProgress(tr("Preparando instalação em %1").arg(targetPath));
-
-    if (!ensureTargetDirectory(targetPath, error, action)) {
-        result.message = error;
+    if (targetPaths.isEmpty()) {
+        result.message = tr("Nenhum destino de instalação foi informado.");
         return result;
     }
 
-    if (!copyPayload(targetPath, error)) {
-        result.message = error;
-        return result;
+    emit installationProgress(tr("Preparando instalação em %1").arg(targetPaths.join(QStringLiteral(", "))));
+
+    // A ação pedida (atualização ou reparo) só vale para destinos que já têm
+    // uma instalação registrada; os demais recebem uma instalação nova.
+    const QStringList installedTargets = detectInstallation().installedTargets;
+    std::vector<CopyTarget> targets(static_cast<size_t>(targetPaths.size()));
+    bool anyTargetReady = false;
+    InstallAction resultAction = InstallAction::FreshInstall;
+    for (int index = 0; index < targetPaths.size(); ++index) {
+        CopyTarget &target = targets[static_cast<size_t>(index)];
+        target.path = targetPaths.at(index);
+        target.action = installedTargets.contains(target.path) ? action : InstallAction::FreshInstall;
+        if (target.action != InstallAction::FreshInstall) {
+            resultAction = target.action;
+        }
+        if (targetPaths.size() > 1) {
+            emit installationProgress(tr("%1: %2").arg(target.path, describeAction(target.action)));
+        }
+        if (!ensureTargetDirectory(target.path, target.error, target.action)) {
+            emit installationProgress(target.error);
+        }
+        anyTargetReady = anyTargetReady || !target.failed();
     }
 
-    if (!saveInstallerState(targetPath)) {
-        result.message = tr("Não foi possível salvar o estado da instalação.");
+    // Etapas pós-cópia. O estado e os atalhos esperam a cópia completa: os atalhos apontam para o primeiro destino
+    // bem-sucedido e não são criados quando a cópia falha, para não deixar
+    // lançadores apontando para uma árvore pela metade.
+    const QString copyMilestone = tr("cópia dos arquivos");
+    const QString stateTask = tr("estado da instalação");
+    QStringList installedPaths;
+    // installedPaths só é lido por tarefas liberadas pelo marco da cópia, que
+    // só é concluído com sucesso quando há ao menos um destino instalado.
+    const auto shortcutPath = [&installedPaths]() {
+        return installedPaths.first();
+    };
+
+    PostInstallGraph postInstall;
+    postInstall.setProgressHandler([this](const QString &task, int progressValue) {
+        emit taskProgress(task, progressValue);
+    });
+    postInstall.addMilestone(copyMilestone);
+    postInstall.addTask(stateTask, {copyMilestone}, [this, &installedPaths](const PostInstallGraph::Reporter &, QString &taskError) {
+        if (!saveInstallerState(installedPaths)) {
+            taskError = tr("Não foi possível salvar o estado da instalação.");
+            return false;
+        }
+        return true;
+    });
+    if (createDesktopShortcut) {
+        postInstall.addTask(tr("atalho na área de trabalho"), {copyMilestone}, [this, shortcutPath](const PostInstallGraph::Reporter &, QString &taskError) {
+            const QString targetPath = shortcutPath();
+            return this->createDesktopShortcut(targetPath, executablePathForShortcuts(targetPath), taskError);
+        });
+    }
+    if (createMenuShortcut) {
+        postInstall.addTask(tr("atalho no menu de aplicativos"), {copyMilestone}, [this, shortcutPath](const PostInstallGraph::Reporter &, QString &taskError) {
+            const QString targetPath = shortcutPath();
+            return this->createMenuShortcut(targetPath, executablePathForShortcuts(targetPath), taskError);
+        });
+    }
+    postInstall.start();
+
+    bool copied = anyTargetReady && copyPayload(targets, error);
+
+    QStringList copiedPaths;
+    for (const CopyTarget &target : targets) {
+        TargetResult targetResult;
+        targetResult.path = target.path;
+        targetResult.success = copied && !target.failed();
+        targetResult.message = target.failed() ? target.error : error;
+        result.targets.append(targetResult);
+        if (targetResult.success) {
+            copiedPaths.append(target.path);
+        }
+    }
+
+    installedPaths = copiedPaths;
+    const QString copyError = !error.isEmpty() ? error : targets.front().error;
+    postInstall.completeMilestones(!installedPaths.isEmpty(), copyError);
+    postInstall.waitForFinished();
+
+    bool stateSaved = false;
+    bool shortcutsCreated = true;
+    for (const PostInstallGraph::Result &task : postInstall.results()) {
+        TaskResult taskResult;
+        taskResult.name = task.name;
+        taskResult.success = task.success;
+        taskResult.message = task.message;
+        taskResult.elapsedMs = task.elapsedMs;
+        result.tasks.append(taskResult);
+
+        if (task.success) {
+            emit installationProgress(tr("Etapa %1 concluída em %2 ms").arg(task.name).arg(task.elapsedMs));
+        } else if (!installedPaths.isEmpty()) {
+            emit installationProgress(tr("Etapa %1 falhou: %2").arg(task.name, task.message));
+        }
+        if (task.name == stateTask) {
+            stateSaved = task.success;
+        } else {
+            shortcutsCreated = shortcutsCreated && task.success;
+        }
+    }
+
+    if (installedPaths.isEmpty()) {
+        result.message = copyError;
         return result;
     }
 
-    QString shortcutError;
-    const bool shortcutsCreated = createShortcuts(targetPath, createDesktopShortcut, createMenuShortcut, shortcutError);
-    if (!shortcutsCreated && !shortcutError.isEmpty()) {
-        emit installationProgress(shortcutError);
+    emit installationProgress(tr("Etapas pós-cópia concluídas %1 ms após a cópia (soma das etapas: %2 ms)")
+                                  .arg(postInstall.tailMs())
+                                  .arg(postInstall.totalTaskMs()));
+
+    if (!stateSaved) {
+        result.message = tr("Não foi possível salvar o estado da instalação.");
+        return result;
     }
 
     emit installationStep(100);
 
     result.success = true;
-    switch (action) {
+    switch (resultAction) {
     case InstallAction::FreshInstall:
         result.message = tr("Instalação concluída com sucesso.");
         break;
@@ -162,6 +552,15 @@ InstallerLogic::InstallResult InstallerLogic::performInstallation(const QString
         result.message += QLatin1Char('\n') + tr("Alguns atalhos não puderam ser criados. Consulte o log para mais detalhes.");
     }
 
+    if (installedPaths.size() != static_cast<int>(targets.size())) {
+        result.success = false;
+        for (const TargetResult &targetResult : result.targets) {
+            result.message += QLatin1Char('\n') + (targetResult.success
+                                                       ? tr("%1: instalado").arg(targetResult.path)
+                                                       : tr("%1: falhou (%2)").arg(targetResult.path, targetResult.message));
+        }
+    }
+
     return result;
 }
 
@@ -175,7 +574,25 @@ QString InstallerLogic::installerStateFilePath() const {
     return dir.filePath(QStringLiteral("anything-llm/installer-state.json"));
 }
 
-bool InstallerLogic::saveInstallerState(const QString &path) const {
+bool InstallerLogic::saveInstallerState(const QStringList &paths) const {
+    // Destinos instalados em execuções anteriores continuam registrados (e
+    // vigiados) enquanto existirem; os desta execução vêm primeiro.
+    QStringList recorded = paths;
+    for (const QString &previous : detectInstallation().installedTargets) {
+        if (!recorded.contains(previous) && QDir(previous).exists()) {
+            recorded.append(previous);
+        }
+    }
+
+    // Momento de término da cópia em cada destino; a verificação trata como
+    // alterado um arquivo modificado depois dele.
+    QJsonObject installTimes;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QString &path : std::as_const(recorded)) {
+        const qint64 previous = recordedInstallTime(path);
+        installTimes.insert(path, static_cast<double>(paths.contains(path) || previous < 0 ? now : previous));
+    }
+
     QFile stateFile(installerStateFilePath());
     QDir().mkpath(QFileInfo(stateFile).path());
     if (!stateFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
@@ -183,9 +600,20 @@ bool InstallerLogic::saveInstallerState(const QString &path) const {
     }
 
     QJsonObject obj;
-    obj.insert(QStringLiteral("path"), path);
+    obj.insert(QStringLiteral("path"), recorded.first());
+    if (recorded.size() > 1) {
+        QJsonArray targets;
+        for (const QString &path : std::as_const(recorded)) {
+            targets.append(path);
+        }
+        obj.insert(QStringLiteral("targets"), targets);
+    }
+    obj.insert(QStringLiteral("targetTimes"), installTimes);
     obj.insert(QStringLiteral("version"), m_availableVersion);
     obj.insert(QStringLiteral("modified"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    if (!m_copyTimings.isEmpty()) {
+        obj.insert(QStringLiteral("copyTimings"), m_copyTimings);
+    }
 
     const QJsonDocument doc(obj);
     const qint64 written = stateFile.write(doc.toJson(QJsonDocument::Indented));
@@ -193,6 +621,17 @@ bool InstallerLogic::saveInstallerState(const QString &path) const {
     return written > 0;
 }
 
+qint64 InstallerLogic::recordedInstallTime(const QString &targetPath) const {
+    QFile stateFile(installerStateFilePath());
+    if (!stateFile.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QJsonObject times = QJsonDocument::fromJson(stateFile.readAll()).object().value(QStringLiteral("targetTimes")).toObject();
+    stateFile.close();
+    const QJsonValue time = times.value(sanitizePath(targetPath));
+    return time.isDouble() ? static_cast<qint64>(time.toDouble()) : -1;
+}
+
 QString InstallerLogic::payloadDirectory() const {
     return QDir(QCoreApplication::applicationDirPath()).filePath(QStringLiteral("payload"));
 }
@@ -220,72 +659,827 @@ bool InstallerLogic::ensureTargetDirectory(const QString &path, QString &error,
     return true;
 }
 
-bool InstallerLogic::copyPayload(const QString &targetPath, QString &error) {
+bool InstallerLogic::copyPayload(std::vector<CopyTarget> &targets, QString &error) {
+    // O pacote anexado ao executável tem prioridade sobre o diretório payload.
+    const bool embedded = m_embeddedPayload->isPresent();
     const QString source = payloadDirectory();
     QDir sourceDir(source);
-    if (!sourceDir.exists()) {
+    if (!embedded && !sourceDir.exists()) {
         error = tr("Pacote de instalação ausente em %1").arg(source);
         return false;
     }
 
     emit installationProgress(tr("Copiando arquivos da aplicação..."));
 
-    m_totalFiles = countPayloadFiles(source);
     m_copiedFiles = 0;
-    if (!copyDirectoryRecursively(source, targetPath, error)) {
+    m_copiedBytes = 0;
+    m_reportedPercent = -1;
+    m_fileMessageTimer.invalidate();
+    m_bufferPool = std::make_unique<BufferPool>(m_copyOptions.largeFileBufferSize, m_copyOptions.bufferPoolCapacity);
+    bool copied = false;
+    if (embedded) {
+        copied = copyEmbeddedPayload(targets, error);
+    } else {
+#ifdef Q_OS_LINUX
+        PayloadTree tree;
+        copied = tree.scan(source, error);
+        if (copied) {
+            m_payloadFiles = static_cast<qint64>(tree.files().size());
+            m_totalFiles = m_payloadFiles;
+            copied = copyPayloadTree(tree, source, targets, error);
+        }
+#else
+        // Fora do Linux a origem também é lida uma única vez, com os blocos
+        // gravados em todos os destinos.
+        m_payloadFiles = countPayloadFiles(source);
+        m_totalFiles = m_payloadFiles;
+        copied = copyDirectoryRecursively(source, targets, error);
+        for (const CopyTarget &target : targets) {
+            if (target.failed()) {
+                emit installationProgress(tr("Destino %1 falhou: %2").arg(target.path, target.error));
+            }
+        }
+#endif
+    }
+
+    const double mebibyte = 1024.0 * 1024.0;
+    emit installationProgress(tr("Buffers de cópia: pico de %1 MiB (limite %2 MiB, %3 esperas por buffer livre)")
+                                  .arg(static_cast<double>(m_bufferPool->peakBytesInUse()) / mebibyte, 0, 'f', 1)
+                                  .arg(static_cast<double>(m_bufferPool->capacityBytes()) / mebibyte, 0, 'f', 1)
+                                  .arg(m_bufferPool->waitCount()));
+    m_bufferPool.reset();
+    if (!copied) {
         return false;
     }
 
     if (m_totalFiles == 0) {
         emit installationStep(100);
+        for (const CopyTarget &target : targets) {
+            if (!target.failed()) {
+                emit targetProgress(target.path, 100);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool InstallerLogic::verifyInstallation(const QString &targetPath, QStringList &damaged, QString &error) {
+    damaged.clear();
+    const QDir target(targetPath);
+    // Sem registro (estado de uma versão anterior do instalador) apenas a
+    // existência e o tamanho são comparados.
+    const qint64 installedAt = recordedInstallTime(targetPath);
+    const auto modified = [installedAt](const QFileInfo &installed) {
+        return installedAt >= 0 && installed.lastModified().toMSecsSinceEpoch() > installedAt + kModificationToleranceMs;
+    };
+    if (m_embeddedPayload->isPresent()) {
+        PayloadTree tree;
+        if (!m_embeddedPayload->load(tree, error)) {
+            return false;
+        }
+        for (const PayloadTree::File &file : tree.files()) {
+            const QString relativePath = tree.relativeFilePath(file);
+            const QFileInfo installed(target.filePath(relativePath));
+            if (!installed.isFile() || installed.size() != file.size || modified(installed)) {
+                damaged.append(relativePath);
+            }
+        }
+        m_embeddedPayload->unload();
+        return true;
     }
 
+    const QString source = payloadDirectory();
+    const QDir sourceDir(source);
+    if (!sourceDir.exists()) {
+        error = tr("Pacote de instalação ausente em %1").arg(source);
+        return false;
+    }
+    QDirIterator it(source, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString relativePath = sourceDir.relativeFilePath(info.absoluteFilePath());
+        const QFileInfo installed(target.filePath(relativePath));
+        if (!installed.isFile() || installed.size() != info.size() || modified(installed)) {
+            damaged.append(relativePath);
+        }
+    }
     return true;
 }
 
-bool InstallerLogic::copyDirectoryRecursively(const QString &source, const QString &destination, QString &error) {
+bool InstallerLogic::repairFiles(const QString &targetPath, const QStringList &relativePaths, QStringList &repaired, QString &error) {
+    repaired.clear();
+    QSet<QString> files;
+    QStringList folders;
+    for (const QString &relativePath : relativePaths) {
+        if (relativePath.endsWith(QLatin1Char('/'))) {
+            folders.append(relativePath);
+        } else {
+            files.insert(relativePath);
+        }
+    }
+    const auto selected = [&files, &folders](const QString &relativePath) {
+        return files.contains(relativePath)
+               || std::any_of(folders.cbegin(), folders.cend(), [&relativePath](const QString &folder) { return relativePath.startsWith(folder); });
+    };
+
+    const QDir target(targetPath);
+    // O arquivo regravado volta à data registrada da instalação, para que a
+    // próxima verificação completa não o aponte como alterado.
+    const qint64 installedAt = recordedInstallTime(targetPath);
+    const auto restoreTime = [installedAt](QFile &destination) {
+        if (installedAt >= 0 && destination.flush()) {
+            destination.setFileTime(QDateTime::fromMSecsSinceEpoch(installedAt), QFileDevice::FileModificationTime);
+        }
+    };
+    if (m_embeddedPayload->isPresent()) {
+        PayloadTree tree;
+        if (!m_embeddedPayload->load(tree, error)) {
+            return false;
+        }
+        bool ok = true;
+        for (const PayloadTree::File &file : tree.files()) {
+            const QString relativePath = tree.relativeFilePath(file);
+            if (!selected(relativePath)) {
+                continue;
+            }
+            const QString destinationPath = target.filePath(relativePath);
+            QDir().mkpath(QFileInfo(destinationPath).path());
+            QFile::remove(destinationPath);
+            QFile destination(destinationPath);
+            const char *contents = reinterpret_cast<const char *>(m_embeddedPayload->data() + file.dataOffset);
+            if (!destination.open(QIODevice::WriteOnly | QIODevice::NewOnly) || destination.write(contents, file.size) != file.size) {
+                error = tr("Falha ao reparar %1: %2").arg(relativePath, destination.errorString());
+                ok = false;
+                break;
+            }
+            restoreTime(destination);
+            destination.close();
+            destination.setPermissions(EmbeddedPayload::permissionsFromMode(file.mode));
+            repaired.append(relativePath);
+        }
+        m_embeddedPayload->unload();
+        return ok;
+    }
+
+    const QString source = payloadDirectory();
+    const QDir sourceDir(source);
+    if (!sourceDir.exists()) {
+        error = tr("Pacote de instalação ausente em %1").arg(source);
+        return false;
+    }
+    QStringList pending(files.cbegin(), files.cend());
+    for (const QString &folder : folders) {
+        QDirIterator it(sourceDir.filePath(folder), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            pending.append(sourceDir.relativeFilePath(it.fileInfo().absoluteFilePath()));
+        }
+    }
+    pending.removeDuplicates();
+
+    for (const QString &relativePath : pending) {
+        // Arquivos criados pelo usuário fora do pacote não são tocados.
+        const QString sourcePath = sourceDir.filePath(relativePath);
+        if (!QFileInfo(sourcePath).isFile()) {
+            continue;
+        }
+        // Gravado direto no destino (O_EXCL após a remoção), sem o arquivo
+        // temporário de QFile::copy, cujos eventos chegariam ao vigia como
+        // pendências de um nome fora do pacote.
+        const QString destinationPath = target.filePath(relativePath);
+        QDir().mkpath(QFileInfo(destinationPath).path());
+        QFile::remove(destinationPath);
+        QFile input(sourcePath);
+        QFile destination(destinationPath);
+        if (!input.open(QIODevice::ReadOnly)) {
+            error = tr("Falha ao reparar %1: %2").arg(relativePath, input.errorString());
+            return false;
+        }
+        if (!destination.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+            error = tr("Falha ao reparar %1: %2").arg(relativePath, destination.errorString());
+            return false;
+        }
+        while (!input.atEnd()) {
+            const QByteArray chunk = input.read(kRepairChunkSize);
+            if (chunk.isEmpty()) {
+                if (input.error() != QFileDevice::NoError) {
+                    error = tr("Falha ao reparar %1: %2").arg(relativePath, input.errorString());
+                    return false;
+                }
+                break;
+            }
+            if (destination.write(chunk) != chunk.size()) {
+                error = tr("Falha ao reparar %1: %2").arg(relativePath, destination.errorString());
+                return false;
+            }
+        }
+        restoreTime(destination);
+        destination.close();
+        destination.setPermissions(input.permissions());
+        repaired.append(relativePath);
+    }
+    return true;
+}
+
+bool InstallerLogic::copyDirectoryRecursively(const QString &source, std::vector<CopyTarget> &targets, QString &error) {
     QDir sourceDir(source);
-    QDirIterator it(source, QDir::NoDotAndDotDot | QDir::AllEntries, QDirIterator::Subdirectories);
+    QDirIterator it(source, QDir::NoDotAndDotDot | QDir::AllEntries | QDir::Hidden, QDirIterator::Subdirectories);
+    std::vector<std::unique_ptr<QFile>> destinations(targets.size());
 
     while (it.hasNext()) {
         it.next();
         const QFileInfo info = it.fileInfo();
         const QString relativePath = sourceDir.relativeFilePath(info.absoluteFilePath());
-        const QString target = QDir(destination).filePath(relativePath);
 
         if (info.isDir()) {
-            if (!QDir().mkpath(target)) {
-                error = tr("Não foi possível criar a pasta %1").arg(target);
-                return false;
+            for (CopyTarget &target : targets) {
+                const QString path = QDir(target.path).filePath(relativePath);
+                if (!target.failed() && !QDir().mkpath(path)) {
+                    target.error = tr("Não foi possível criar a pasta %1").arg(path);
+                }
             }
         } else {
-            const QString targetDir = QFileInfo(target).path();
-            if (!QDir().mkpath(targetDir)) {
-                error = tr("Não foi possível criar a pasta %1").arg(targetDir);
+            // A origem é lida uma única vez; cada bloco segue para todos os
+            // destinos ainda válidos.
+            QFile input(info.absoluteFilePath());
+            if (!input.open(QIODevice::ReadOnly)) {
+                error = tr("Falha ao ler %1: %2").arg(relativePath, input.errorString());
                 return false;
             }
-            if (QFile::exists(target)) {
-                QFile::remove(target);
+            for (size_t index = 0; index < targets.size(); ++index) {
+                CopyTarget &target = targets[index];
+                destinations[index].reset();
+                if (target.failed()) {
+                    continue;
+                }
+                const QString path = QDir(target.path).filePath(relativePath);
+                const QString targetDir = QFileInfo(path).path();
+                if (!QDir().mkpath(targetDir)) {
+                    target.error = tr("Não foi possível criar a pasta %1").arg(targetDir);
+                    continue;
+                }
+                auto destination = std::make_unique<QFile>(path);
+                if (destination->exists()) {
+                    destination->remove();
+                }
+                if (!destination->open(QIODevice::WriteOnly)) {
+                    target.error = tr("Falha ao copiar %1: %2").arg(relativePath, destination->errorString());
+                    continue;
+                }
+                destinations[index] = std::move(destination);
             }
-            if (!QFile::copy(info.absoluteFilePath(), target)) {
-                error = tr("Falha ao copiar %1").arg(relativePath);
+
+            QElapsedTimer timer;
+            timer.start();
+            BufferPool::Lease buffer = m_bufferPool->acquire();
+            qint64 copiedBytes = 0;
+            while (!input.atEnd()) {
+                const qint64 chunk = input.read(buffer.data(), buffer.size());
+                if (chunk < 0) {
+                    error = tr("Falha ao ler %1: %2").arg(relativePath, input.errorString());
+                    return false;
+                }
+                if (chunk == 0) {
+                    break;
+                }
+                for (size_t index = 0; index < targets.size(); ++index) {
+                    QFile *destination = destinations[index].get();
+                    if (destination && destination->write(buffer.data(), chunk) != chunk) {
+                        targets[index].error = tr("Falha ao copiar %1: %2").arg(relativePath, destination->errorString());
+                        destinations[index].reset();
+                    }
+                }
+                copiedBytes += chunk;
+            }
+            buffer.release();
+
+            for (size_t index = 0; index < targets.size(); ++index) {
+                QFile *destination = destinations[index].get();
+                if (!destination) {
+                    continue;
+                }
+                destination->close();
+                if (destination->error() != QFileDevice::NoError) {
+                    targets[index].error = tr("Falha ao copiar %1: %2").arg(relativePath, destination->errorString());
+                    continue;
+                }
+                destination->setPermissions(info.permissions());
+                recordTargetFile(targets[index]);
+            }
+            if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+                error = tr("Todos os destinos falharam; o último erro foi: %1").arg(targets.back().error);
                 return false;
             }
-            ++m_copiedFiles;
-            if (m_totalFiles > 0) {
-                const int percent = static_cast<int>((static_cast<double>(m_copiedFiles) / static_cast<double>(m_totalFiles)) * 100.0);
-                emit installationStep(qBound(0, percent, 100));
+
+            if (m_copyOptions.largeFileThreshold > 0 && info.size() >= m_copyOptions.largeFileThreshold) {
+                LargeFileCopier::Stats stats;
+                stats.logicalSize = info.size();
+                stats.bytesCopied = copiedBytes;
+                stats.elapsedMs = timer.elapsed();
+                emit installationProgress(describeLargeFileCopy(relativePath, stats));
+            }
+            m_copiedBytes += copiedBytes;
+            if (recordCopiedFile()) {
+                emit installationProgress(tr("Copiado %1").arg(relativePath));
+            }
+        }
+    }
+
+    if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+        error = tr("Nenhum destino pôde ser instalado.");
+        return false;
+    }
+    return true;
+}
+
+#ifdef Q_OS_LINUX
+bool InstallerLogic::copyPayloadTree(const PayloadTree &tree, const QString &source, std::vector<CopyTarget> &targets, QString &error) {
+    const int sourceRoot = ::open(QFile::encodeName(source).constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (sourceRoot < 0) {
+        error = tr("Não foi possível abrir %1: %2").arg(source, systemError());
+        return false;
+    }
+
+    int cacheCapacity = kDirectoryHandlesPerCache;
+    bool ok = openTreeTargets(tree, targets, cacheCapacity, error);
+    if (ok) {
+        DirectoryHandleCache sourceDirs(tree, sourceRoot, false, cacheCapacity);
+        std::vector<LargeFileCopier::Destination> streams;
+        streams.reserve(targets.size());
+
+        QElapsedTimer timer;
+        timer.start();
+        const std::vector<int> schedule = scheduleCopy(tree, sourceDirs);
+        const qint64 schedulingMs = timer.elapsed();
+        const bool batched = m_copyOptions.copyOrder != CopyOrder::DirectoryOrder;
+        std::vector<int> batchFds(kReadBatchFiles, -1);
+
+        const size_t fileCount = schedule.size();
+        for (size_t batchStart = 0; ok && batchStart < fileCount; batchStart += kReadBatchFiles) {
+            const size_t batchEnd = std::min(fileCount, batchStart + kReadBatchFiles);
+            // Os descritores abertos para a leitura antecipada seguem para a
+            // cópia, sem uma segunda abertura por arquivo.
+            std::fill(batchFds.begin(), batchFds.end(), -1);
+            if (batched) {
+                for (size_t position = batchStart; position < batchEnd; ++position) {
+                    const PayloadTree::File &file = tree.files()[static_cast<size_t>(schedule[position])];
+                    QString ignored;
+                    const int directoryFd = sourceDirs.handle(file.directory, ignored);
+                    const int fd = directoryFd < 0 ? -1 : openat(directoryFd, tree.fileName(file), O_RDONLY | O_CLOEXEC);
+                    if (fd >= 0) {
+                        readahead(fd, 0, kReadBatchBytesPerFile);
+                    }
+                    batchFds[position - batchStart] = fd;
+                }
+            }
+            for (size_t position = batchStart; position < batchEnd; ++position) {
+                const int fd = batchFds[position - batchStart];
+                if (ok) {
+                    ok = copyTreeFile(tree, schedule[position], fd, sourceDirs, targets, streams, error);
+                } else if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+        }
+
+        if (ok) {
+            reportCopyTiming(timer.elapsed(), schedulingMs);
+        }
+    }
+
+    closeTreeTargets(targets);
+    ::close(sourceRoot);
+    return ok;
+}
+
+bool InstallerLogic::openTreeTargets(const PayloadTree &tree, std::vector<CopyTarget> &targets, int &cacheCapacity, QString &error) {
+    // Os caches dos destinos e o da origem dividem os descritores disponíveis.
+    const qint64 targetCount = std::count_if(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); });
+    const qint64 fileLimit = raiseOpenFileLimit();
+    const qint64 perCache = (fileLimit - fixedDescriptors(targetCount)) / (targetCount + 1);
+    if (perCache < kMinDirectoryHandlesPerCache) {
+        qint64 maxTargets = 0;
+        while (fixedDescriptors(maxTargets + 1) + (maxTargets + 2) * kMinDirectoryHandlesPerCache <= fileLimit) {
+            ++maxTargets;
+        }
+        error = tr("Destinos demais para o limite de %1 arquivos abertos: instale em no máximo %2 destinos por vez ou aumente o limite (ulimit -n)")
+                    .arg(fileLimit)
+                    .arg(maxTargets);
+        return false;
+    }
+    cacheCapacity = static_cast<int>(std::min<qint64>(perCache, kDirectoryHandlesPerCache));
+
+    // Diretórios são criados uma única vez por destino, antes dos arquivos,
+    // para que pastas vazias também existam.
+    const int directoryCount = static_cast<int>(tree.directories().size());
+    for (CopyTarget &target : targets) {
+        if (target.failed()) {
+            continue;
+        }
+        target.rootFd = ::open(QFile::encodeName(target.path).constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (target.rootFd < 0) {
+            target.error = tr("Não foi possível abrir %1: %2").arg(target.path, systemError());
+            continue;
+        }
+        target.directories = std::make_unique<DirectoryHandleCache>(tree, target.rootFd, true, cacheCapacity);
+        for (int directory = 1; !target.failed() && directory < directoryCount; ++directory) {
+            target.directories->handle(directory, target.error);
+        }
+    }
+
+    if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+        error = targets.front().error;
+        return false;
+    }
+    return true;
+}
+
+void InstallerLogic::closeTreeTargets(std::vector<CopyTarget> &targets) {
+    for (CopyTarget &target : targets) {
+        target.directories.reset();
+        if (target.rootFd >= 0) {
+            ::close(target.rootFd);
+            target.rootFd = -1;
+        }
+        if (target.failed()) {
+            emit installationProgress(tr("Destino %1 falhou: %2").arg(target.path, target.error));
+        }
+    }
+}
+
+std::vector<int> InstallerLogic::scheduleCopy(const PayloadTree &tree, DirectoryHandleCache &sourceDirs) const {
+    const std::vector<PayloadTree::File> &files = tree.files();
+    std::vector<int> schedule(files.size());
+    for (size_t index = 0; index < schedule.size(); ++index) {
+        schedule[index] = static_cast<int>(index);
+    }
+
+    switch (m_copyOptions.copyOrder) {
+    case CopyOrder::DirectoryOrder:
+        break;
+    case CopyOrder::InodeOrder:
+        std::stable_sort(schedule.begin(), schedule.end(), [&files](int left, int right) {
+            return files[static_cast<size_t>(left)].inode < files[static_cast<size_t>(right)].inode;
+        });
+        break;
+    case CopyOrder::PhysicalOrder: {
+        // Sem FIEMAP o deslocamento é 0 e o inode desempata, o que já
+        // aproxima a ordem de alocação na maioria dos sistemas de arquivos.
+        std::vector<quint64> physical(files.size(), 0);
+        for (size_t index = 0; index < files.size(); ++index) {
+            QString ignored;
+            const int directoryFd = sourceDirs.handle(files[index].directory, ignored);
+            const int fd = directoryFd < 0 ? -1 : openat(directoryFd, tree.fileName(files[index]), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) {
+                physical[index] = firstPhysicalOffset(fd);
+                ::close(fd);
+            }
+        }
+        std::stable_sort(schedule.begin(), schedule.end(), [&files, &physical](int left, int right) {
+            const size_t l = static_cast<size_t>(left);
+            const size_t r = static_cast<size_t>(right);
+            if (physical[l] != physical[r]) {
+                return physical[l] < physical[r];
+            }
+            return files[l].inode < files[r].inode;
+        });
+        break;
+    }
+    }
+
+    return schedule;
+}
+
+bool InstallerLogic::copyTreeFile(const PayloadTree &tree,
+                                  int fileIndex,
+                                  int sourceFd,
+                                  DirectoryHandleCache &sourceDirs,
+                                  std::vector<CopyTarget> &targets,
+                                  std::vector<LargeFileCopier::Destination> &streams,
+                                  QString &error) {
+    const PayloadTree::File &file = tree.files()[static_cast<size_t>(fileIndex)];
+    const char *name = tree.fileName(file);
+    if (sourceFd < 0) {
+        const int sourceDir = sourceDirs.handle(file.directory, error);
+        if (sourceDir < 0) {
+            return false;
+        }
+        sourceFd = openat(sourceDir, name, O_RDONLY | O_CLOEXEC);
+    }
+    if (sourceFd < 0) {
+        error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+        return false;
+    }
+
+    struct stat sourceInfo;
+    if (fstat(sourceFd, &sourceInfo) != 0) {
+        error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+        ::close(sourceFd);
+        return false;
+    }
+
+    const qint64 size = sourceInfo.st_size;
+    const bool largeFile = m_copyOptions.largeFileThreshold > 0 && size >= m_copyOptions.largeFileThreshold;
+
+    // Abre o arquivo em cada destino ativo. Reflinks (FICLONE) não leem a
+    // origem e são resolvidos aqui; os demais destinos recebem os dados em leque.
+    // Arquivos grandes tentam o reflink dentro do LargeFileCopier.
+    streams.clear();
+    std::vector<int> &streamTargets = m_streamTargets;
+    streamTargets.clear();
+    for (size_t index = 0; index < targets.size(); ++index) {
+        CopyTarget &target = targets[index];
+        if (target.failed()) {
+            continue;
+        }
+        const int destinationDir = target.directories->handle(file.directory, target.error);
+        if (destinationDir < 0) {
+            continue;
+        }
+        const int destinationFd = openDestinationFile(destinationDir, name);
+        if (destinationFd < 0) {
+            target.error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+            continue;
+        }
+        if (!largeFile && (size == 0 || ioctl(destinationFd, FICLONE, sourceFd) == 0)) {
+            fchmod(destinationFd, sourceInfo.st_mode & 07777);
+            if (::close(destinationFd) != 0) {
+                target.error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+            } else {
+                recordTargetFile(target);
+            }
+            continue;
+        }
+        LargeFileCopier::Destination stream;
+        stream.fd = destinationFd;
+        streams.push_back(stream);
+        streamTargets.push_back(static_cast<int>(index));
+    }
+
+    bool ok = true;
+    const int streamCount = static_cast<int>(streams.size());
+    if (streamCount > 0 && largeFile) {
+        LargeFileCopier::Options options;
+        options.bufferSize = m_copyOptions.largeFileBufferSize;
+        options.directIo = m_copyOptions.directIo;
+        options.bufferPool = m_bufferPool.get();
+
+        LargeFileCopier::Stats stats;
+        QString copyError;
+        ok = LargeFileCopier::copy(sourceFd, streams.data(), streamCount, options, stats, copyError);
+        if (ok) {
+            emit installationProgress(describeLargeFileCopy(tree.relativeFilePath(file), stats));
+        } else {
+            error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), copyError);
+        }
+    } else if (streamCount == 1) {
+        // Um único destino: copy_file_range mantém os dados no kernel.
+        if (!copyFileContents(sourceFd, streams.front().fd, size, m_bufferPool.get())) {
+            streams.front().error = systemError();
+        }
+    } else if (streamCount > 1) {
+        ok = fanOutContents(sourceFd, streams.data(), streamCount, m_bufferPool.get());
+        if (!ok) {
+            error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+        }
+    }
+
+    for (int index = 0; index < streamCount; ++index) {
+        LargeFileCopier::Destination &stream = streams[static_cast<size_t>(index)];
+        CopyTarget &target = targets[static_cast<size_t>(streamTargets[static_cast<size_t>(index)])];
+        if (!largeFile && !stream.failed()) {
+            fchmod(stream.fd, sourceInfo.st_mode & 07777);
+        }
+        if (::close(stream.fd) != 0 && !stream.failed()) {
+            stream.error = systemError();
+        }
+        if (!ok) {
+            continue;
+        }
+        if (stream.failed()) {
+            target.error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), stream.error);
+        } else {
+            recordTargetFile(target);
+        }
+    }
+    ::close(sourceFd);
+    if (!ok) {
+        return false;
+    }
+
+    if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+        error = tr("Todos os destinos falharam; o último erro foi: %1").arg(targets.back().error);
+        return false;
+    }
+
+    m_copiedBytes += size;
+    if (recordCopiedFile()) {
+        emit installationProgress(tr("Copiado %1").arg(tree.relativeFilePath(file)));
+    }
+    return true;
+}
+#endif
+
+bool InstallerLogic::copyEmbeddedPayload(std::vector<CopyTarget> &targets, QString &error) {
+    QElapsedTimer timer;
+    timer.start();
+
+    PayloadTree tree;
+    if (!m_embeddedPayload->load(tree, error)) {
+        return false;
+    }
+    m_payloadFiles = static_cast<qint64>(tree.files().size());
+    m_totalFiles = m_payloadFiles;
+    emit installationProgress(tr("Usando o pacote embutido em %1 (%2 arquivos, índice lido em %3 ms)")
+                                  .arg(m_embeddedPayload->executablePath())
+                                  .arg(m_payloadFiles)
+                                  .arg(timer.elapsed()));
+
+    // Os dados são gravados direto do mapeamento, sem extração temporária;
+    // com vários destinos cada página é lida do disco uma única vez.
+    const uchar *data = m_embeddedPayload->data();
+#ifdef Q_OS_LINUX
+    int cacheCapacity = kDirectoryHandlesPerCache;
+    bool ok = openTreeTargets(tree, targets, cacheCapacity, error);
+    for (size_t fileIndex = 0; ok && fileIndex < tree.files().size(); ++fileIndex) {
+        const PayloadTree::File &file = tree.files()[fileIndex];
+        const char *name = tree.fileName(file);
+        const char *contents = reinterpret_cast<const char *>(data + file.dataOffset);
+        const bool largeFile = m_copyOptions.largeFileThreshold > 0 && file.size >= m_copyOptions.largeFileThreshold;
+        for (CopyTarget &target : targets) {
+            if (target.failed()) {
+                continue;
+            }
+            const int destinationDir = target.directories->handle(file.directory, target.error);
+            if (destinationDir < 0) {
+                continue;
+            }
+            const int destinationFd = openDestinationFile(destinationDir, name);
+            if (destinationFd < 0) {
+                target.error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), systemError());
+                continue;
+            }
+            if (largeFile) {
+                posix_fallocate(destinationFd, 0, file.size);
+            }
+            bool written = writeFully(destinationFd, contents, file.size) && fchmod(destinationFd, file.mode) == 0;
+            QString writeError = written ? QString() : systemError();
+            if (::close(destinationFd) != 0 && written) {
+                written = false;
+                writeError = systemError();
+            }
+            if (written) {
+                recordTargetFile(target);
+            } else {
+                target.error = tr("Falha ao copiar %1: %2").arg(tree.relativeFilePath(file), writeError);
+            }
+        }
+
+        if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+            error = tr("Todos os destinos falharam; o último erro foi: %1").arg(targets.back().error);
+            ok = false;
+            break;
+        }
+        m_copiedBytes += file.size;
+        if (recordCopiedFile()) {
+            emit installationProgress(tr("Copiado %1").arg(tree.relativeFilePath(file)));
+        }
+    }
+    closeTreeTargets(targets);
+#else
+    for (CopyTarget &target : targets) {
+        for (size_t directory = 1; !target.failed() && directory < tree.directories().size(); ++directory) {
+            const QString path = QDir(target.path).filePath(tree.relativeDirectoryPath(static_cast<int>(directory)));
+            if (!QDir().mkpath(path)) {
+                target.error = tr("Não foi possível criar a pasta %1").arg(path);
+            }
+        }
+    }
+
+    bool ok = true;
+    for (const PayloadTree::File &file : tree.files()) {
+        const QString relativePath = tree.relativeFilePath(file);
+        const char *contents = reinterpret_cast<const char *>(data + file.dataOffset);
+        for (CopyTarget &target : targets) {
+            if (target.failed()) {
+                continue;
+            }
+            QFile destination(QDir(target.path).filePath(relativePath));
+            if (destination.exists()) {
+                destination.remove();
             }
+            if (!destination.open(QIODevice::WriteOnly) || destination.write(contents, file.size) != file.size) {
+                target.error = tr("Falha ao copiar %1: %2").arg(relativePath, destination.errorString());
+                continue;
+            }
+            destination.close();
+            destination.setPermissions(EmbeddedPayload::permissionsFromMode(file.mode));
+            recordTargetFile(target);
+        }
+
+        if (std::none_of(targets.begin(), targets.end(), [](const CopyTarget &target) { return !target.failed(); })) {
+            error = tr("Todos os destinos falharam; o último erro foi: %1").arg(targets.back().error);
+            ok = false;
+            break;
+        }
+        m_copiedBytes += file.size;
+        if (recordCopiedFile()) {
             emit installationProgress(tr("Copiado %1").arg(relativePath));
         }
     }
+#endif
+
+    m_embeddedPayload->unload();
+    if (ok) {
+        const double mebibytes = static_cast<double>(m_copiedBytes) / (1024.0 * 1024.0);
+        const double seconds = static_cast<double>(std::max<qint64>(timer.elapsed(), 1)) / 1000.0;
+        emit installationProgress(tr("Pacote embutido copiado em %1 s: %2 arquivos, %3 MiB, %4 MiB/s")
+                                      .arg(seconds, 0, 'f', 2)
+                                      .arg(m_copiedFiles)
+                                      .arg(mebibytes, 0, 'f', 1)
+                                      .arg(mebibytes / seconds, 0, 'f', 1));
+    }
+    return ok;
+}
+
+void InstallerLogic::reportCopyTiming(qint64 elapsedMs, qint64 schedulingMs) {
+    const double mebibytes = static_cast<double>(m_copiedBytes) / (1024.0 * 1024.0);
+    const double seconds = static_cast<double>(std::max<qint64>(elapsedMs, 1)) / 1000.0;
+    const double throughput = mebibytes / seconds;
+    const QString order = copyOrderKey(m_copyOptions.copyOrder);
+
+    emit installationProgress(tr("Cópia concluída em %1 s: %2 arquivos, %3 MiB, %4 MiB/s (ordem %5, agendamento %6 ms)")
+                                  .arg(seconds, 0, 'f', 2)
+                                  .arg(m_copiedFiles)
+                                  .arg(mebibytes, 0, 'f', 1)
+                                  .arg(throughput, 0, 'f', 1)
+                                  .arg(order)
+                                  .arg(schedulingMs));
+
+    // Compara com as medições anteriores das outras ordens, guardadas no
+    // estado do instalador. As execuções não partem do mesmo estado do cache
+    // de páginas, por isso a diferença é apenas indicativa.
+    QFile stateFile(installerStateFilePath());
+    if (stateFile.open(QIODevice::ReadOnly)) {
+        m_copyTimings = QJsonDocument::fromJson(stateFile.readAll()).object().value(QStringLiteral("copyTimings")).toObject();
+        stateFile.close();
+    }
+    const QStringList orders = {QStringLiteral("directory"), QStringLiteral("inode"), QStringLiteral("physical")};
+    for (const QString &other : orders) {
+        const double previous = m_copyTimings.value(other).toObject().value(QStringLiteral("mibPerSecond")).toDouble();
+        if (other == order || previous <= 0.0) {
+            continue;
+        }
+        emit installationProgress(tr("Medição anterior com ordem %1: %2 MiB/s (%3%4%, indicativo: o cache de páginas daquela execução pode ter sido outro)")
+                                      .arg(other)
+                                      .arg(previous, 0, 'f', 1)
+                                      .arg(throughput >= previous ? QStringLiteral("+") : QString())
+                                      .arg((throughput / previous - 1.0) * 100.0, 0, 'f', 1));
+    }
+
+    QJsonObject timing;
+    timing.insert(QStringLiteral("seconds"), seconds);
+    timing.insert(QStringLiteral("files"), m_copiedFiles);
+    timing.insert(QStringLiteral("mibPerSecond"), throughput);
+    timing.insert(QStringLiteral("measured"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    m_copyTimings.insert(order, timing);
+}
+
+void InstallerLogic::recordTargetFile(CopyTarget &target) {
+    ++target.copiedFiles;
+    if (m_payloadFiles <= 0) {
+        return;
+    }
+    const int percent = qBound(0, static_cast<int>((static_cast<double>(target.copiedFiles) / static_cast<double>(m_payloadFiles)) * 100.0), 100);
+    if (percent != target.reportedPercent) {
+        target.reportedPercent = percent;
+        emit targetProgress(target.path, percent);
+    }
+}
+
+bool InstallerLogic::recordCopiedFile() {
+    ++m_copiedFiles;
+    if (m_totalFiles > 0) {
+        const int percent = qBound(0, static_cast<int>((static_cast<double>(m_copiedFiles) / static_cast<double>(m_totalFiles)) * 100.0), 100);
+        if (percent != m_reportedPercent) {
+            m_reportedPercent = percent;
+            emit installationStep(percent);
+        }
+    }
 
+    // Informa se já é hora de registrar outra mensagem de arquivo copiado.
+    if (m_fileMessageTimer.isValid() && m_fileMessageTimer.elapsed() < kFileMessageIntervalMs && m_copiedFiles != m_totalFiles) {
+        return false;
+    }
+    m_fileMessageTimer.start();
     return true;
 }
 
 qint64 InstallerLogic::countPayloadFiles(const QString &source) const {
     qint64 count = 0;
-    QDirIterator it(source, QDir::Files, QDirIterator::Subdirectories);
+    QDirIterator it(source, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
     while (it.hasNext()) {
         it.next();
         ++count;
@@ -321,24 +1515,6 @@ QString InstallerLogic::executablePathForShortcuts(const QString &installDir) co
 #endif
 }
 
-bool InstallerLogic::createShortcuts(const QString &targetPath, bool desktop, bool menu, QString &error) const {
-    if (!desktop && !menu) {
-        return true;
-    }
-
-    const QString executable = executablePathForShortcuts(targetPath);
-
-    if (desktop && !createDesktopShortcut(targetPath, executable, error)) {
-        return false;
-    }
-
-    if (menu && !createMenuShortcut(targetPath, executable, error)) {
-        return false;
-    }
-
-    return true;
-}
-
 bool InstallerLogic::createDesktopShortcut(const QString &targetPath, const QString &executable, QString &error) const {
     Q_UNUSED(targetPath)
 #ifdef Q_OS_WIN
@@ -1,14 +1,29 @@
 #ifndef INSTALLERLOGIC_H
 #define INSTALLERLOGIC_H
 
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QMetaType>
 
+#include "largefilecopier.h"
+#include "payloadtree.h"
+
+#include <memory>
+#include <vector>
+
+class BufferPool;
+class DirectoryHandleCache;
+class EmbeddedPayload;
+
 class InstallerLogic : public QObject {
     Q_OBJECT
 public:
     explicit InstallerLogic(QObject *parent = nullptr);
+    ~InstallerLogic() override;
 
     enum class InstallAction {
         FreshInstall,
@@ -17,6 +32,15 @@ public:
     };
     Q_ENUM(InstallAction)
 
+    // Ordem em que os arquivos do pacote são copiados. As ordens por inode e
+    // por posição física (FIEMAP) reduzem buscas em HDDs e volumes de rede.
+    enum class CopyOrder {
+        DirectoryOrder,
+        InodeOrder,
+        PhysicalOrder
+    };
+    Q_ENUM(CopyOrder)
+
     struct InstallationStatus {
         bool installed = false;
         bool updateAvailable = false;
@@ -24,12 +48,41 @@ public:
         QString installedVersion;
         QString availableVersion;
         QString installPath;
+        // Todos os destinos registrados no estado, incluindo installPath.
+        QStringList installedTargets;
         InstallAction recommendedAction = InstallAction::FreshInstall;
     };
 
+    struct TargetResult {
+        QString path;
+        bool success = false;
+        QString message;
+    };
+
+    struct TaskResult {
+        QString name;
+        bool success = false;
+        QString message;
+        qint64 elapsedMs = 0;
+    };
+
     struct InstallResult {
         bool success = false;
         QString message;
+        QList<TargetResult> targets;
+        QList<TaskResult> tasks;
+    };
+
+    struct CopyOptions {
+        // Arquivos a partir deste tamanho usam o caminho de cópia dedicado
+        // (pré-alocação, buracos preservados). Zero desativa o caminho.
+        qint64 largeFileThreshold = 64 * 1024 * 1024;
+        qint64 largeFileBufferSize = 8 * 1024 * 1024;
+        bool directIo = false;
+        // Teto de memória para todos os buffers de cópia, independentemente
+        // do tamanho do pacote.
+        qint64 bufferPoolCapacity = 64 * 1024 * 1024;
+        CopyOrder copyOrder = CopyOrder::DirectoryOrder;
     };
 
     void startDetection();
@@ -37,39 +90,93 @@ public:
                            InstallAction action,
                            bool createDesktopShortcut,
                            bool createMenuShortcut);
+    // Instala a mesma versão em vários destinos lendo o pacote uma única vez.
+    // action vale para os destinos que já têm uma instalação registrada; os
+    // demais são instalações novas.
+    void startInstallation(const QStringList &targetPaths,
+                           InstallAction action,
+                           bool createDesktopShortcut,
+                           bool createMenuShortcut);
 
     QString defaultInstallPath() const;
     QString availableVersion() const;
 
+    // Detecção síncrona, usada pelo modo de vigilância fora da interface.
+    InstallationStatus detectInstallation() const;
+    // Verificação completa: compara existência, tamanho e data de modificação
+    // (com a registrada ao fim da instalação) de cada arquivo do pacote e
+    // devolve os caminhos relativos divergentes.
+    bool verifyInstallation(const QString &targetPath, QStringList &damaged, QString &error);
+    // Reparo incremental: recopia do pacote apenas os caminhos indicados.
+    // Entradas terminadas em "/" representam pastas inteiras.
+    bool repairFiles(const QString &targetPath, const QStringList &relativePaths, QStringList &repaired, QString &error);
+
+    void setCopyOptions(const CopyOptions &options);
+    CopyOptions copyOptions() const;
+
 signals:
     void detectionFinished(const InstallerLogic::InstallationStatus &status);
     void installationProgress(const QString &message);
     void installationStep(int progressValue);
+    void targetProgress(const QString &targetPath, int progressValue);
+    void taskProgress(const QString &taskName, int progressValue);
     void installationFinished(const InstallerLogic::InstallResult &result);
 
 private:
-    InstallationStatus detectInstallation() const;
-    InstallResult performInstallation(const QString &targetPath,
+    struct CopyTarget;
+
+    InstallResult performInstallation(const QStringList &targetPaths,
                                       InstallAction action,
                                       bool createDesktopShortcut,
                                       bool createMenuShortcut);
 
     QString installerStateFilePath() const;
-    bool saveInstallerState(const QString &path) const;
+    bool saveInstallerState(const QStringList &paths) const;
+    // Data (ms desde a época) em que a cópia terminou no destino, ou -1.
+    qint64 recordedInstallTime(const QString &targetPath) const;
     QString payloadDirectory() const;
     bool ensureTargetDirectory(const QString &path, QString &error, InstallAction action) const;
-    bool copyPayload(const QString &targetPath, QString &error);
-    bool copyDirectoryRecursively(const QString &source, const QString &destination, QString &error);
+    bool copyPayload(std::vector<CopyTarget> &targets, QString &error);
+    bool copyDirectoryRecursively(const QString &source, std::vector<CopyTarget> &targets, QString &error);
+    bool copyEmbeddedPayload(std::vector<CopyTarget> &targets, QString &error);
+#ifdef Q_OS_LINUX
+    bool copyPayloadTree(const PayloadTree &tree, const QString &source, std::vector<CopyTarget> &targets, QString &error);
+    bool openTreeTargets(const PayloadTree &tree, std::vector<CopyTarget> &targets, int &cacheCapacity, QString &error);
+    void closeTreeTargets(std::vector<CopyTarget> &targets);
+    std::vector<int> scheduleCopy(const PayloadTree &tree, DirectoryHandleCache &sourceDirs) const;
+    // sourceFd pode trazer a origem já aberta pela leitura antecipada do lote
+    // (-1 abre aqui); em ambos os casos o descritor é fechado ao final.
+    bool copyTreeFile(const PayloadTree &tree,
+                      int fileIndex,
+                      int sourceFd,
+                      DirectoryHandleCache &sourceDirs,
+                      std::vector<CopyTarget> &targets,
+                      std::vector<LargeFileCopier::Destination> &streams,
+                      QString &error);
+#endif
+    bool recordCopiedFile();
+    void recordTargetFile(CopyTarget &target);
+    void reportCopyTiming(qint64 elapsedMs, qint64 schedulingMs);
     qint64 countPayloadFiles(const QString &source) const;
     int compareVersions(const QString &left, const QString &right) const;
     QString executablePathForShortcuts(const QString &installDir) const;
-    bool createShortcuts(const QString &targetPath, bool desktop, bool menu, QString &error) const;
     bool createDesktopShortcut(const QString &targetPath, const QString &executable, QString &error) const;
     bool createMenuShortcut(const QString &targetPath, const QString &executable, QString &error) const;
 
     QString m_availableVersion;
+    CopyOptions m_copyOptions;
+    std::unique_ptr<EmbeddedPayload> m_embeddedPayload;
+    std::unique_ptr<BufferPool> m_bufferPool;
+    // Etapas pós-cópia em andamento, avisadas de cada arquivo copiado.
     qint64 m_totalFiles = 0;
+    qint64 m_payloadFiles = 0;
     qint64 m_copiedFiles = 0;
+    qint64 m_copiedBytes = 0;
+    QJsonObject m_copyTimings;
+    // Índices dos destinos que recebem o arquivo atual; reaproveitado entre arquivos.
+    std::vector<int> m_streamTargets;
+    int m_reportedPercent = -1;
+    QElapsedTimer m_fileMessageTimer;
 };
 
 Q_DECLARE_METATYPE(InstallerLogic::InstallationStatus)
@@ -23,11 +23,17 @@ InstallerWindow::InstallerWindow(QWidget *parent)
     connect(m_logic, &InstallerLogic::detectionFinished, this, &InstallerWindow::handleDetectionFinished);
     connect(m_logic, &InstallerLogic::installationProgress, this, &InstallerWindow::handleInstallationProgress);
     connect(m_logic, &InstallerLogic::installationStep, this, &InstallerWindow::handleInstallationStep);
+    connect(m_logic, &InstallerLogic::targetProgress, this, &InstallerWindow::handleTargetProgress);
+    connect(m_logic, &InstallerLogic::taskProgress, this, &InstallerWindow::handleTaskProgress);
     connect(m_logic, &InstallerLogic::installationFinished, this, &InstallerWindow::handleInstallationFinished);
 
     triggerDetection();
 }
 
+void InstallerWindow::setCopyOptions(const InstallerLogic::CopyOptions &options) {
+    m_logic->setCopyOptions(options);
+}
+
 void InstallerWindow::buildUi() {
     setWindowTitle(tr("Instalador AnythingLLM"));
     setWindowIcon(QIcon(QStringLiteral(":/icons/app-icon.png")));
@@ -46,6 +52,7 @@ void InstallerWindow::buildUi() {
     auto *pathLabel = new QLabel(tr("Local de instalação:"), this);
     m_pathEdit = new QLineEdit(this);
     m_pathEdit->setPlaceholderText(tr("Selecione o diretório onde AnythingLLM será instalado"));
+    m_pathEdit->setToolTip(tr("Separe vários destinos com \";\" para instalar em todos lendo o pacote uma única vez."));
     auto *browseButton = new QPushButton(tr("Selecionar..."), this);
     connect(browseButton, &QPushButton::clicked, this, &InstallerWindow::browseForPath);
     pathLayout->addWidget(pathLabel);
@@ -99,6 +106,25 @@ void InstallerWindow::handleInstallationStep(int value) {
     m_progressBar->setValue(value);
 }
 
+void InstallerWindow::handleTargetProgress(const QString &targetPath, int value) {
+    // Registra cada destino apenas a cada 25% para não poluir o log.
+    const int milestone = value / 25;
+    if (m_targetMilestones.value(targetPath, -1) == milestone) {
+        return;
+    }
+    m_targetMilestones.insert(targetPath, milestone);
+    if (milestone > 0) {
+        appendLogMessage(tr("Destino %1: %2%").arg(targetPath).arg(milestone * 25));
+    }
+}
+
+void InstallerWindow::handleTaskProgress(const QString &taskName, int value) {
+    // A conclusão de cada etapa, com tempo ou erro, chega pelo log da lógica.
+    if (value == 0) {
+        appendLogMessage(tr("Etapa %1 iniciada").arg(taskName));
+    }
+}
+
 void InstallerWindow::handleInstallationFinished(const InstallerLogic::InstallResult &result) {
     m_installationInProgress = false;
     setUiEnabled(true);
@@ -118,24 +144,30 @@ void InstallerWindow::startInstallation() {
         return;
     }
 
-    const QString targetPath = m_pathEdit->text().trimmed();
-    if (targetPath.isEmpty()) {
+    QStringList targetPaths;
+    for (const QString &path : m_pathEdit->text().split(QLatin1Char(';'), Qt::SkipEmptyParts)) {
+        const QString trimmedPath = path.trimmed();
+        if (!trimmedPath.isEmpty()) {
+            targetPaths.append(trimmedPath);
+        }
+    }
+    if (targetPaths.isEmpty()) {
         QMessageBox::warning(this, tr("Instalação"), tr("Informe um local de instalação válido."));
         return;
     }
 
-    InstallerLogic::InstallAction action = m_currentStatus.recommendedAction;
-    if (m_currentStatus.installed && targetPath != m_currentStatus.installPath) {
-        action = InstallerLogic::InstallAction::FreshInstall;
-    }
+    // InstallerLogic aplica a ação recomendada apenas aos destinos que já têm
+    // a instalação registrada; os demais recebem uma instalação nova.
+    const InstallerLogic::InstallAction action = m_currentStatus.recommendedAction;
 
     m_installationInProgress = true;
     setUiEnabled(false);
     m_progressBar->setValue(0);
     m_logOutput->clear();
+    m_targetMilestones.clear();
 
     appendLogMessage(tr("Iniciando processo de instalação..."));
-    m_logic->startInstallation(targetPath, action, m_desktopShortcutCheck->isChecked(), m_menuShortcutCheck->isChecked());
+    m_logic->startInstallation(targetPaths, action, m_desktopShortcutCheck->isChecked(), m_menuShortcutCheck->isChecked());
 }
 
 void InstallerWindow::browseForPath() {
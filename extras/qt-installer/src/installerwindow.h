@@ -1,6 +1,7 @@
 #ifndef INSTALLERWINDOW_H
 #define INSTALLERWINDOW_H
 
+#include <QHash>
 #include <QMainWindow>
 
 #include "installerlogic.h"
@@ -17,6 +18,8 @@ class InstallerWindow : public QMainWindow {
 public:
     explicit InstallerWindow(QWidget *parent = nullptr);
 
+    void setCopyOptions(const InstallerLogic::CopyOptions &options);
+
 protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -24,6 +27,8 @@ private slots:
     void handleDetectionFinished(const InstallerLogic::InstallationStatus &status);
     void handleInstallationProgress(const QString &message);
     void handleInstallationStep(int value);
+    void handleTargetProgress(const QString &targetPath, int value);
+    void handleTaskProgress(const QString &taskName, int value);
     void handleInstallationFinished(const InstallerLogic::InstallResult &result);
     void startInstallation();
     void browseForPath();
@@ -38,6 +43,7 @@ private:
     InstallerLogic *m_logic = nullptr;
     InstallerLogic::InstallationStatus m_currentStatus;
     bool m_installationInProgress = false;
+    QHash<QString, int> m_targetMilestones;
 
     QLabel *m_statusLabel = nullptr;
     QLineEdit *m_pathEdit = nullptr;
@@ -0,0 +1,305 @@
+#include "integritywatcher.h"
+#include "installerlogic.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <QStringList>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+// Eventos que indicam conteúdo alterado, removido ou substituído. IN_CREATE só
+// serve para vigiar pastas novas: arquivos novos fora do pacote não são reparados.
+constexpr uint32_t kWatchMask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                                | IN_CREATE | IN_MOVE_SELF | IN_ONLYDIR;
+
+// Par de sockets do padrão "self-pipe": o tratador de sinal apenas grava um
+// byte, e o laço de eventos do Qt chama repairNow() fora do contexto do sinal.
+int signalSockets[2] = {-1, -1};
+// O par de sockets e o notificador são do processo; cada SIGUSR1 repara
+// todos os vigilantes registrados.
+QSocketNotifier *signalNotifier = nullptr;
+QList<IntegrityWatcher *> signalWatchers;
+
+void handleUserSignal(int) {
+    const char byte = 1;
+    const ssize_t ignored = ::write(signalSockets[0], &byte, sizeof(byte));
+    Q_UNUSED(ignored)
+}
+
+QString systemError() {
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+#endif
+}
+
+IntegrityWatcher::IntegrityWatcher(InstallerLogic *logic, const QString &installPath, QObject *parent)
+    : QObject(parent),
+      m_logic(logic),
+      m_installPath(QDir(installPath).absolutePath()) {
+    connect(&m_repairTimer, &QTimer::timeout, this, &IntegrityWatcher::repairNow);
+}
+
+IntegrityWatcher::~IntegrityWatcher() {
+#ifdef Q_OS_LINUX
+    signalWatchers.removeAll(this);
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+#endif
+}
+
+bool IntegrityWatcher::start(QString &error) {
+#ifdef Q_OS_LINUX
+    if (!QDir(m_installPath).exists()) {
+        error = tr("Diretório de instalação não encontrado: %1").arg(m_installPath);
+        return false;
+    }
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        error = tr("Não foi possível iniciar o inotify: %1").arg(systemError());
+        return false;
+    }
+    if (!watchDirectory(QString())) {
+        error = tr("Não foi possível vigiar %1: %2").arg(m_installPath, systemError());
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &IntegrityWatcher::readEvents);
+
+    emit message(tr("Vigiando %1 (%2 pastas)").arg(m_installPath).arg(m_watches.size()));
+
+    // O conjunto de alterações não sobrevive a reinícios, por isso a primeira
+    // passada é uma verificação completa. Os watches já estão ativos, então
+    // nada que mude durante a verificação se perde.
+    m_fullScanNeeded = true;
+    repairNow();
+    return true;
+#else
+    error = tr("O modo de vigilância usa inotify e está disponível apenas no Linux.");
+    return false;
+#endif
+}
+
+void IntegrityWatcher::setRepairInterval(int seconds) {
+    if (seconds > 0) {
+        m_repairTimer.start(seconds * 1000);
+    } else {
+        m_repairTimer.stop();
+    }
+}
+
+bool IntegrityWatcher::repairOnUserSignal(QString &error) {
+#ifdef Q_OS_LINUX
+    if (!signalNotifier) {
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, signalSockets) != 0) {
+            error = tr("Não foi possível preparar o tratamento de SIGUSR1: %1").arg(systemError());
+            return false;
+        }
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = handleUserSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        if (sigaction(SIGUSR1, &action, nullptr) != 0) {
+            error = tr("Não foi possível preparar o tratamento de SIGUSR1: %1").arg(systemError());
+            return false;
+        }
+
+        signalNotifier = new QSocketNotifier(signalSockets[1], QSocketNotifier::Read);
+        connect(signalNotifier, &QSocketNotifier::activated, []() {
+            char byte = 0;
+            const ssize_t ignored = ::read(signalSockets[1], &byte, sizeof(byte));
+            Q_UNUSED(ignored)
+            const QList<IntegrityWatcher *> watchers = signalWatchers;
+            for (IntegrityWatcher *watcher : watchers) {
+                watcher->handleRepairSignal();
+            }
+        });
+    }
+    if (!signalWatchers.contains(this)) {
+        signalWatchers.append(this);
+    }
+    return true;
+#else
+    error = tr("Reparo sob demanda por sinal está disponível apenas no Linux.");
+    return false;
+#endif
+}
+
+QStringList IntegrityWatcher::dirtyPaths() const {
+    return QStringList(m_dirty.cbegin(), m_dirty.cend());
+}
+
+void IntegrityWatcher::repairNow() {
+    readEvents();
+
+    QStringList pending(m_dirty.cbegin(), m_dirty.cend());
+    m_dirty.clear();
+
+    QString error;
+    if (m_fullScanNeeded || m_watchLimitReached) {
+        QElapsedTimer timer;
+        timer.start();
+        QStringList damaged;
+        if (!m_logic->verifyInstallation(m_installPath, damaged, error)) {
+            emit message(error);
+            for (const QString &path : pending) {
+                m_dirty.insert(path);
+            }
+            return;
+        }
+        emit message(tr("Verificação completa em %1 ms: %2 arquivos divergentes").arg(timer.elapsed()).arg(damaged.size()));
+        pending += damaged;
+        pending.removeDuplicates();
+        m_fullScanNeeded = false;
+    }
+
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    QStringList repaired;
+    const bool ok = m_logic->repairFiles(m_installPath, pending, repaired, error);
+
+    // Descarta apenas os eventos dos arquivos que o próprio reparo regravou;
+    // alterações externas em outros arquivos durante o reparo continuam
+    // entrando nas pendências.
+    m_suppressedPaths = QSet<QString>(repaired.cbegin(), repaired.cend());
+    readEvents();
+    m_suppressedPaths.clear();
+
+#ifdef Q_OS_LINUX
+    if (m_rootWatch < 0 && m_inotifyFd >= 0) {
+        // A raiz foi removida e recriada pelo reparo; volta a vigiar a árvore.
+        watchDirectory(QString());
+    }
+#endif
+
+    if (!ok) {
+        emit message(error);
+        for (const QString &path : pending) {
+            if (!repaired.contains(path)) {
+                m_dirty.insert(path);
+            }
+        }
+    }
+    emit message(tr("Reparo incremental: %1 arquivos restaurados a partir de %2 entradas pendentes").arg(repaired.size()).arg(pending.size()));
+}
+
+void IntegrityWatcher::readEvents() {
+#ifdef Q_OS_LINUX
+    if (m_inotifyFd < 0) {
+        return;
+    }
+
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    for (;;) {
+        const ssize_t length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: fila vazia.
+            break;
+        }
+
+        for (const char *cursor = buffer; cursor < buffer + length;) {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                m_fullScanNeeded = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                m_watches.remove(event->wd);
+                if (event->wd == m_rootWatch) {
+                    m_rootWatch = -1;
+                    m_fullScanNeeded = true;
+                }
+                continue;
+            }
+            if (event->mask & IN_MOVE_SELF) {
+                // Renomeações dentro da árvore já atualizaram o caminho do watch
+                // em IN_MOVED_TO; se a pasta saiu da instalação, o watch é
+                // descartado (o evento no diretório pai já a marcou).
+                const auto moved = m_watches.constFind(event->wd);
+                if (event->wd != m_rootWatch && moved != m_watches.constEnd()
+                    && !QFileInfo(QDir(m_installPath).filePath(*moved)).isDir()) {
+                    inotify_rm_watch(m_inotifyFd, event->wd);
+                }
+                continue;
+            }
+
+            const auto watch = m_watches.constFind(event->wd);
+            if (watch == m_watches.constEnd() || event->len == 0) {
+                continue;
+            }
+            const QString name = QFile::decodeName(event->name);
+            const QString relativePath = watch->isEmpty() ? name : *watch + QLatin1Char('/') + name;
+
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    watchDirectory(relativePath);
+                }
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+                    m_dirty.insert(relativePath + QLatin1Char('/'));
+                }
+                continue;
+            }
+            if (!(event->mask & IN_CREATE) && !m_suppressedPaths.contains(relativePath)) {
+                m_dirty.insert(relativePath);
+            }
+        }
+    }
+#endif
+}
+
+void IntegrityWatcher::handleRepairSignal() {
+    emit message(tr("SIGUSR1 recebido: reparando %1 entradas pendentes em %2").arg(m_dirty.size()).arg(m_installPath));
+    repairNow();
+}
+
+bool IntegrityWatcher::watchDirectory(const QString &relativePath) {
+#ifdef Q_OS_LINUX
+    const QString absolutePath = relativePath.isEmpty() ? m_installPath : QDir(m_installPath).filePath(relativePath);
+    const int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(absolutePath).constData(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOSPC && !m_watchLimitReached) {
+            // Sem watches suficientes (fs.inotify.max_user_watches) a vigilância
+            // fica parcial e cada reparo volta a fazer a verificação completa.
+            m_watchLimitReached = true;
+            emit message(tr("Limite de watches do inotify atingido em %1; cada reparo fará uma verificação completa.").arg(absolutePath));
+        }
+        return false;
+    }
+    m_watches.insert(wd, relativePath);
+    if (relativePath.isEmpty()) {
+        m_rootWatch = wd;
+    }
+
+    QDirIterator it(absolutePath, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (it.hasNext()) {
+        it.next();
+        const QString name = it.fileName();
+        watchDirectory(relativePath.isEmpty() ? name : relativePath + QLatin1Char('/') + name);
+    }
+    return true;
+#else
+    Q_UNUSED(relativePath)
+    return false;
+#endif
+}
@@ -0,0 +1,60 @@
+#ifndef INTEGRITYWATCHER_H
+#define INTEGRITYWATCHER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+class InstallerLogic;
+class QSocketNotifier;
+
+// Vigia uma instalação com inotify e mantém o conjunto de arquivos alterados
+// ou removidos desde o último reparo. Apenas esses arquivos são recopiados do
+// pacote, sob demanda (SIGUSR1) ou periodicamente. A verificação completa só
+// acontece ao iniciar, após estouro da fila do inotify ou quando o limite de
+// watches do sistema impede vigiar toda a árvore.
+class IntegrityWatcher : public QObject {
+    Q_OBJECT
+public:
+    IntegrityWatcher(InstallerLogic *logic, const QString &installPath, QObject *parent = nullptr);
+    ~IntegrityWatcher() override;
+
+    bool start(QString &error);
+    // Zero desativa o reparo periódico; o reparo fica apenas sob demanda.
+    void setRepairInterval(int seconds);
+    // Dispara repairNow() a cada SIGUSR1 recebido pelo processo. Vários
+    // vigilantes podem se registrar; todos são reparados a cada sinal.
+    bool repairOnUserSignal(QString &error);
+
+    QStringList dirtyPaths() const;
+
+public slots:
+    void repairNow();
+
+signals:
+    void message(const QString &text);
+
+private slots:
+    void readEvents();
+    void handleRepairSignal();
+
+private:
+    bool watchDirectory(const QString &relativePath);
+
+    InstallerLogic *m_logic = nullptr;
+    QString m_installPath;
+    int m_inotifyFd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QHash<int, QString> m_watches;
+    QSet<QString> m_dirty;
+    // Arquivos regravados pelo reparo em andamento, cujos eventos são ignorados.
+    QSet<QString> m_suppressedPaths;
+    QTimer m_repairTimer;
+    int m_rootWatch = -1;
+    bool m_fullScanNeeded = true;
+    bool m_watchLimitReached = false;
+};
+
+#endif // INTEGRITYWATCHER_H
@@ -0,0 +1,397 @@
+#include "largefilecopier.h"
+#include "bufferpool.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr qint64 kDirectIoAlignment = 4096;
+
+struct AlignedFree {
+    void operator()(char *buffer) const { std::free(buffer); }
+};
+
+using AlignedBuffer = std::unique_ptr<char, AlignedFree>;
+
+AlignedBuffer allocateAligned(qint64 size) {
+    void *memory = nullptr;
+#ifdef Q_OS_LINUX
+    if (posix_memalign(&memory, kDirectIoAlignment, static_cast<size_t>(size)) != 0) {
+        memory = nullptr;
+    }
+#else
+    memory = std::malloc(static_cast<size_t>(size));
+#endif
+    return AlignedBuffer(static_cast<char *>(memory));
+}
+
+qint64 normalizedBufferSize(qint64 requested) {
+    const qint64 size = std::max<qint64>(requested, kDirectIoAlignment);
+    return (size / kDirectIoAlignment) * kDirectIoAlignment;
+}
+
+// Buffer de trabalho: emprestado do pool quando houver, senão próprio.
+struct CopyBuffer {
+    BufferPool::Lease lease;
+    AlignedBuffer owned;
+    char *data = nullptr;
+    qint64 size = 0;
+
+    explicit CopyBuffer(const LargeFileCopier::Options &options) {
+        if (options.bufferPool) {
+            lease = options.bufferPool->acquire();
+            data = lease.data();
+            size = lease.size();
+        } else {
+            size = normalizedBufferSize(options.bufferSize);
+            owned = allocateAligned(size);
+            data = owned.get();
+        }
+    }
+};
+
+#ifdef Q_OS_LINUX
+QString systemError() {
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+// Falhas de pré-alocação não são fatais: alguns sistemas de arquivos (tmpfs
+// antigos, NFS, FAT) não suportam fallocate e a cópia continua normalmente.
+void preallocate(int fd, off_t offset, off_t length) {
+    if (length <= 0) {
+        return;
+    }
+    if (fallocate(fd, 0, offset, length) != 0 && errno != EOPNOTSUPP && errno != ENOSYS) {
+        posix_fallocate(fd, offset, length);
+    }
+}
+
+bool writeFully(int fd, const char *data, qint64 length, off_t offset, bool &directIo) {
+    if (directIo && ((offset % kDirectIoAlignment) != 0 || (length % kDirectIoAlignment) != 0)) {
+        // O trecho final raramente é alinhado; desligamos O_DIRECT para ele.
+        const int flags = fcntl(fd, F_GETFL);
+        if (flags >= 0) {
+            fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+        }
+        directIo = false;
+    }
+
+    while (length > 0) {
+        const ssize_t written = pwrite(fd, data, static_cast<size_t>(length), offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        offset += written;
+        length -= written;
+    }
+    return true;
+}
+
+// Copia [0, size) no kernel com offsets explícitos. Retorna false sem dados
+// gravados quando o par de sistemas de arquivos não suporta copy_file_range,
+// para que o laço com buffer assuma; demais falhas ficam em errno.
+bool copyInKernel(int sourceFd, int destinationFd, off_t size, qint64 &copied, bool &unsupported) {
+    off_t inOffset = 0;
+    off_t outOffset = 0;
+    unsupported = false;
+    while (inOffset < size) {
+        const ssize_t result = copy_file_range(sourceFd, &inOffset, destinationFd, &outOffset, static_cast<size_t>(size - inOffset), 0);
+        if (result > 0) {
+            continue;
+        }
+        if (result == 0) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        unsupported = inOffset == 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP);
+        return false;
+    }
+    copied = inOffset;
+    return true;
+}
+#endif
+}
+
+double LargeFileCopier::Stats::throughputMiBps() const {
+    if (elapsedMs <= 0) {
+        return 0.0;
+    }
+    return (static_cast<double>(bytesCopied) / (1024.0 * 1024.0)) / (static_cast<double>(elapsedMs) / 1000.0);
+}
+
+bool LargeFileCopier::copy(const QString &source,
+                           const QString &destination,
+                           const Options &options,
+                           Stats &stats,
+                           QString &error) {
+#ifdef Q_OS_LINUX
+    const QByteArray sourcePath = QFile::encodeName(source);
+    const QByteArray destinationPath = QFile::encodeName(destination);
+
+    const int sourceFd = ::open(sourcePath.constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        error = tr("Não foi possível abrir %1: %2").arg(source, systemError());
+        return false;
+    }
+
+    const int destinationFd = ::open(destinationPath.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (destinationFd < 0) {
+        error = tr("Não foi possível criar %1: %2").arg(destination, systemError());
+        ::close(sourceFd);
+        return false;
+    }
+
+    bool ok = copy(sourceFd, destinationFd, options, stats, error);
+    ::close(sourceFd);
+    if (::close(destinationFd) != 0 && ok) {
+        error = tr("Falha ao finalizar %1: %2").arg(destination, systemError());
+        ok = false;
+    }
+    return ok;
+#else
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        error = tr("Não foi possível abrir %1: %2").arg(source, in.errorString());
+        return false;
+    }
+    QFile out(destination);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = tr("Não foi possível criar %1: %2").arg(destination, out.errorString());
+        return false;
+    }
+
+    stats = Stats();
+    stats.logicalSize = in.size();
+    // Definir o tamanho final antes de escrever permite ao sistema reservar
+    // extents contíguos (SetEndOfFile no Windows, ftruncate nos demais).
+    out.resize(stats.logicalSize);
+
+    const CopyBuffer buffer(options);
+    if (!buffer.data) {
+        error = tr("Memória insuficiente para copiar %1").arg(source);
+        return false;
+    }
+
+    while (!in.atEnd()) {
+        const qint64 read = in.read(buffer.data, buffer.size);
+        if (read < 0 || out.write(buffer.data, read) != read) {
+            error = tr("Falha ao copiar %1").arg(source);
+            return false;
+        }
+        stats.bytesCopied += read;
+    }
+
+    out.setPermissions(in.permissions());
+    stats.elapsedMs = timer.elapsed();
+    return true;
+#endif
+}
+
+#ifdef Q_OS_LINUX
+bool LargeFileCopier::copy(int sourceFd,
+                           int destinationFd,
+                           const Options &options,
+                           Stats &stats,
+                           QString &error) {
+    Destination destination;
+    destination.fd = destinationFd;
+    if (!copy(sourceFd, &destination, 1, options, stats, error)) {
+        return false;
+    }
+    if (destination.failed()) {
+        error = destination.error;
+        return false;
+    }
+    return true;
+}
+
+bool LargeFileCopier::copy(int sourceFd,
+                           Destination *destinations,
+                           int destinationCount,
+                           const Options &options,
+                           Stats &stats,
+                           QString &error) {
+    QElapsedTimer timer;
+    timer.start();
+    stats = Stats();
+
+    struct stat sourceInfo;
+    if (fstat(sourceFd, &sourceInfo) != 0) {
+        error = tr("Não foi possível ler os atributos do arquivo: %1").arg(systemError());
+        return false;
+    }
+
+    const off_t size = sourceInfo.st_size;
+    stats.logicalSize = size;
+    const bool sparse = static_cast<qint64>(sourceInfo.st_blocks) * 512 < static_cast<qint64>(size);
+
+    // Reflink primeiro: em btrfs/XFS o destino compartilha os extents da
+    // origem e nenhum dado é lido ou gravado, independentemente do tamanho.
+    int pending = 0;
+    int pendingIndex = -1;
+    for (int index = 0; index < destinationCount; ++index) {
+        Destination &destination = destinations[index];
+        destination.cloned = !destination.failed() && ioctl(destination.fd, FICLONE, sourceFd) == 0;
+        if (destination.cloned) {
+            fchmod(destination.fd, sourceInfo.st_mode & 07777);
+            ++stats.clonedDestinations;
+        } else if (!destination.failed()) {
+            ++pending;
+            pendingIndex = index;
+        }
+    }
+    if (pending == 0) {
+        stats.elapsedMs = timer.elapsed();
+        return true;
+    }
+
+    // Um único destino denso e sem O_DIRECT: pré-aloca e copia no kernel,
+    // sem passar os dados pelo espaço do usuário. Arquivos esparsos, O_DIRECT
+    // e cópias em leque continuam no laço com buffer abaixo.
+    if (pending == 1 && !sparse && !options.directIo) {
+        Destination &destination = destinations[pendingIndex];
+        preallocate(destination.fd, 0, size);
+        qint64 copied = 0;
+        bool unsupported = false;
+        if (copyInKernel(sourceFd, destination.fd, size, copied, unsupported)) {
+            if (ftruncate(destination.fd, size) != 0) {
+                destination.error = tr("Falha ao ajustar o tamanho do arquivo: %1").arg(systemError());
+            } else {
+                fchmod(destination.fd, sourceInfo.st_mode & 07777);
+            }
+            stats.bytesCopied = copied;
+            stats.kernelCopy = true;
+            stats.elapsedMs = timer.elapsed();
+            return true;
+        }
+        if (!unsupported) {
+            destination.error = tr("Falha de escrita: %1").arg(systemError());
+            stats.elapsedMs = timer.elapsed();
+            return true;
+        }
+    }
+
+    posix_fadvise(sourceFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    const CopyBuffer buffer(options);
+    if (!buffer.data) {
+        error = tr("Memória insuficiente para o buffer de cópia.");
+        return false;
+    }
+
+    for (int index = 0; index < destinationCount; ++index) {
+        Destination &destination = destinations[index];
+        if (destination.cloned || destination.failed()) {
+            continue;
+        }
+        // Arquivos densos são pré-alocados de uma vez; nos esparsos reservamos
+        // apenas os trechos com dados para não inflar os buracos no disco.
+        if (!sparse) {
+            preallocate(destination.fd, 0, size);
+        }
+        destination.directIo = false;
+        if (options.directIo) {
+            const int flags = fcntl(destination.fd, F_GETFL);
+            destination.directIo = flags >= 0 && fcntl(destination.fd, F_SETFL, flags | O_DIRECT) == 0;
+            stats.directIoUsed = stats.directIoUsed || destination.directIo;
+        }
+    }
+
+    // Cada trecho é lido uma única vez e gravado em todos os destinos; um
+    // destino com falha é marcado e deixa de receber dados, sem afetar os demais.
+    off_t position = 0;
+    while (position < size) {
+        off_t dataStart = lseek(sourceFd, position, SEEK_DATA);
+        if (dataStart < 0) {
+            if (errno == ENXIO) {
+                break;
+            }
+            // Sem suporte a SEEK_DATA: tratamos o restante como dados.
+            dataStart = position;
+        }
+        off_t dataEnd = lseek(sourceFd, dataStart, SEEK_HOLE);
+        if (dataEnd < 0 || dataEnd > size) {
+            dataEnd = size;
+        }
+
+        stats.holeBytes += dataStart - position;
+        if (sparse) {
+            for (int index = 0; index < destinationCount; ++index) {
+                if (!destinations[index].failed() && !destinations[index].cloned) {
+                    preallocate(destinations[index].fd, dataStart, dataEnd - dataStart);
+                }
+            }
+        }
+
+        off_t offset = dataStart;
+        while (offset < dataEnd) {
+            const qint64 chunk = std::min<qint64>(buffer.size, dataEnd - offset);
+            const ssize_t read = pread(sourceFd, buffer.data, static_cast<size_t>(chunk), offset);
+            if (read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                error = tr("Falha de leitura: %1").arg(systemError());
+                return false;
+            }
+            if (read == 0) {
+                // Arquivo encolheu durante a cópia.
+                dataEnd = offset;
+                break;
+            }
+            for (int index = 0; index < destinationCount; ++index) {
+                Destination &destination = destinations[index];
+                if (!destination.failed() && !destination.cloned
+                    && !writeFully(destination.fd, buffer.data, read, offset, destination.directIo)) {
+                    destination.error = tr("Falha de escrita: %1").arg(systemError());
+                }
+            }
+            offset += read;
+            stats.bytesCopied += read;
+        }
+        position = dataEnd;
+    }
+    stats.holeBytes += size - position;
+
+    for (int index = 0; index < destinationCount; ++index) {
+        Destination &destination = destinations[index];
+        if (destination.failed() || destination.cloned) {
+            continue;
+        }
+        // Garante o tamanho lógico final, incluindo um eventual buraco no fim.
+        if (ftruncate(destination.fd, size) != 0) {
+            destination.error = tr("Falha ao ajustar o tamanho do arquivo: %1").arg(systemError());
+            continue;
+        }
+        fchmod(destination.fd, sourceInfo.st_mode & 07777);
+    }
+    posix_fadvise(sourceFd, 0, 0, POSIX_FADV_DONTNEED);
+
+    stats.elapsedMs = timer.elapsed();
+    return true;
+}
+#endif
@@ -0,0 +1,72 @@
+#ifndef LARGEFILECOPIER_H
+#define LARGEFILECOPIER_H
+
+#include <QCoreApplication>
+#include <QString>
+
+class BufferPool;
+
+// Cópia dedicada a arquivos grandes (modelos, bibliotecas nativas etc.).
+// Pré-aloca o destino, preserva buracos de arquivos esparsos e usa buffers
+// grandes e alinhados, opcionalmente com O_DIRECT no Linux.
+class LargeFileCopier {
+    Q_DECLARE_TR_FUNCTIONS(LargeFileCopier)
+public:
+    struct Options {
+        qint64 bufferSize = 8 * 1024 * 1024;
+        bool directIo = false;
+        // Quando definido, o buffer é emprestado do pool em vez de alocado
+        // a cada arquivo e bufferSize é ignorado.
+        BufferPool *bufferPool = nullptr;
+    };
+
+    struct Stats {
+        qint64 logicalSize = 0;
+        qint64 bytesCopied = 0;
+        qint64 holeBytes = 0;
+        qint64 elapsedMs = 0;
+        bool directIoUsed = false;
+        // Destinos resolvidos por reflink (FICLONE), sem copiar dados, e se
+        // o destino restante foi copiado no kernel com copy_file_range.
+        int clonedDestinations = 0;
+        bool kernelCopy = false;
+
+        double throughputMiBps() const;
+    };
+
+    static bool copy(const QString &source,
+                     const QString &destination,
+                     const Options &options,
+                     Stats &stats,
+                     QString &error);
+
+#ifdef Q_OS_LINUX
+    // Destino de uma cópia em leque: falhas de escrita ficam em error e o
+    // destino é ignorado no restante da cópia.
+    struct Destination {
+        int fd = -1;
+        QString error;
+        bool directIo = false;
+        bool cloned = false;
+
+        bool failed() const { return !error.isEmpty(); }
+    };
+
+    static bool copy(int sourceFd,
+                     int destinationFd,
+                     const Options &options,
+                     Stats &stats,
+                     QString &error);
+
+    // Lê a origem uma única vez e grava em todos os destinos. Retorna false
+    // apenas para falhas na origem; as dos destinos ficam em cada Destination.
+    static bool copy(int sourceFd,
+                     Destination *destinations,
+                     int destinationCount,
+                     const Options &options,
+                     Stats &stats,
+                     QString &error);
+#endif
+};
+
+#endif // LARGEFILECOPIER_H
@@ -1,15 +1,121 @@
 #include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include <memory>
+#include <vector>
 
 #include "installerwindow.h"
+#include "integritywatcher.h"
+
+namespace {
+int runIntegrityWatcher(const InstallerLogic::CopyOptions &copyOptions, int repairInterval) {
+    InstallerLogic logic;
+    logic.setCopyOptions(copyOptions);
+
+    const InstallerLogic::InstallationStatus status = logic.detectInstallation();
+    if (!status.installed) {
+        QTextStream(stderr) << QStringLiteral("Nenhuma instalação do AnythingLLM foi encontrada para vigiar.") << Qt::endl;
+        return 1;
+    }
+
+    // Instalações em vários destinos registram todos eles; cada um recebe seu
+    // próprio vigilante.
+    std::vector<std::unique_ptr<IntegrityWatcher>> watchers;
+    for (const QString &installPath : status.installedTargets) {
+        auto watcher = std::make_unique<IntegrityWatcher>(&logic, installPath);
+        QObject::connect(watcher.get(), &IntegrityWatcher::message, [installPath](const QString &text) {
+            QTextStream(stdout) << installPath << QStringLiteral(": ") << text << Qt::endl;
+        });
+        watcher->setRepairInterval(repairInterval);
+
+        QString error;
+        if (!watcher->repairOnUserSignal(error) || !watcher->start(error)) {
+            QTextStream(stderr) << installPath << QStringLiteral(": ") << error << Qt::endl;
+            continue;
+        }
+        watchers.push_back(std::move(watcher));
+    }
+    if (watchers.empty()) {
+        return 1;
+    }
+    return QCoreApplication::exec();
+}
+}
 
 int main(int argc, char *argv[]) {
-    QApplication application(argc, argv);
-    QApplication::setApplicationName(QStringLiteral("AnythingLLM Installer"));
-    QApplication::setOrganizationName(QStringLiteral("Mintplex Labs"));
-    QApplication::setApplicationVersion(QStringLiteral(APP_VERSION));
+    // O modo de vigilância não abre janelas e precisa rodar em servidores sem
+    // display, por isso a aplicação é escolhida antes de interpretar as opções.
+    bool watchMode = false;
+    for (int index = 1; index < argc; ++index) {
+        watchMode = watchMode || qstrcmp(argv[index], "--watch") == 0;
+    }
+    std::unique_ptr<QCoreApplication> application(watchMode ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+    QCoreApplication::setApplicationName(QStringLiteral("AnythingLLM Installer"));
+    QCoreApplication::setOrganizationName(QStringLiteral("Mintplex Labs"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(APP_VERSION));
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption largeFileThresholdOption(QStringLiteral("large-file-threshold"),
+                                                      QStringLiteral("Tamanho (MiB) a partir do qual um arquivo usa a cópia dedicada; 0 desativa."),
+                                                      QStringLiteral("mib"));
+    const QCommandLineOption largeFileBufferOption(QStringLiteral("large-file-buffer"),
+                                                   QStringLiteral("Tamanho (MiB) do buffer usado na cópia de arquivos grandes."),
+                                                   QStringLiteral("mib"));
+    const QCommandLineOption bufferPoolOption(QStringLiteral("buffer-pool"),
+                                              QStringLiteral("Memória máxima (MiB) reservada para buffers de cópia."),
+                                              QStringLiteral("mib"));
+    const QCommandLineOption copyOrderOption(QStringLiteral("copy-order"),
+                                             QStringLiteral("Ordem de cópia: directory (padrão), inode ou physical (FIEMAP), útil em HDDs e volumes de rede."),
+                                             QStringLiteral("ordem"));
+    const QCommandLineOption directIoOption(QStringLiteral("direct-io"),
+                                            QStringLiteral("Grava arquivos grandes com O_DIRECT, sem passar pelo cache de páginas."));
+    parser.addOption(largeFileThresholdOption);
+    parser.addOption(largeFileBufferOption);
+    parser.addOption(bufferPoolOption);
+    parser.addOption(copyOrderOption);
+    const QCommandLineOption watchOption(QStringLiteral("watch"),
+                                         QStringLiteral("Vigia a instalação existente com inotify e repara apenas os arquivos alterados ou removidos (Linux)."));
+    const QCommandLineOption watchIntervalOption(QStringLiteral("watch-interval"),
+                                                 QStringLiteral("Intervalo (segundos) entre reparos no modo de vigilância; 0 repara apenas ao receber SIGUSR1."),
+                                                 QStringLiteral("segundos"),
+                                                 QStringLiteral("0"));
+    parser.addOption(directIoOption);
+    parser.addOption(watchOption);
+    parser.addOption(watchIntervalOption);
+    parser.process(*application);
+
+    InstallerLogic::CopyOptions copyOptions;
+    if (parser.isSet(largeFileThresholdOption)) {
+        copyOptions.largeFileThreshold = parser.value(largeFileThresholdOption).toLongLong() * 1024 * 1024;
+    }
+    if (parser.isSet(largeFileBufferOption)) {
+        copyOptions.largeFileBufferSize = qMax<qint64>(1, parser.value(largeFileBufferOption).toLongLong()) * 1024 * 1024;
+    }
+    if (parser.isSet(bufferPoolOption)) {
+        copyOptions.bufferPoolCapacity = qMax<qint64>(1, parser.value(bufferPoolOption).toLongLong()) * 1024 * 1024;
+    }
+    copyOptions.directIo = parser.isSet(directIoOption);
+    const QString copyOrder = parser.value(copyOrderOption);
+    if (copyOrder == QLatin1String("inode")) {
+        copyOptions.copyOrder = InstallerLogic::CopyOrder::InodeOrder;
+    } else if (copyOrder == QLatin1String("physical")) {
+        copyOptions.copyOrder = InstallerLogic::CopyOrder::PhysicalOrder;
+    } else if (parser.isSet(copyOrderOption) && copyOrder != QLatin1String("directory")) {
+        QTextStream(stderr) << QStringLiteral("Ordem de cópia desconhecida: %1 (use directory, inode ou physical).").arg(copyOrder) << Qt::endl;
+        return 1;
+    }
+
+    if (watchMode) {
+        return runIntegrityWatcher(copyOptions, parser.value(watchIntervalOption).toInt());
+    }
 
     InstallerWindow window;
+    window.setCopyOptions(copyOptions);
     window.show();
 
-    return application.exec();
+    return application->exec();
 }
@@ -0,0 +1,32 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "embeddedpayload.h"
+
+// Anexa o diretório payload ao executável do instalador, gerando um único
+// binário autoextraível. Chamado pelo CMake quando INSTALLER_EMBED_PAYLOAD=ON.
+int main(int argc, char *argv[]) {
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("anything-llm-payload-packer"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Anexa o pacote da aplicação ao executável do instalador."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("instalador"), QStringLiteral("Executável anything-llm-installer."));
+    parser.addPositionalArgument(QStringLiteral("payload"), QStringLiteral("Diretório com os arquivos da aplicação."));
+    parser.addPositionalArgument(QStringLiteral("saida"), QStringLiteral("Executável autoextraível a ser gerado."));
+    parser.process(application);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 3) {
+        parser.showHelp(1);
+    }
+
+    QString error;
+    if (!EmbeddedPayload::pack(arguments.at(0), arguments.at(1), arguments.at(2), error)) {
+        QTextStream(stderr) << error << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "payloadtree.h"
+
+#include <QFile>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void PayloadTree::clear() {
+    m_directories.clear();
+    m_files.clear();
+    m_names.clear();
+    m_names.reserve(256 * 1024);
+
+    // Índice 0 é a raiz do pacote, com nome vazio.
+    m_names.push_back('\0');
+    m_directories.push_back(Directory());
+}
+
+int PayloadTree::addDirectory(int parent, const char *name) {
+    Directory directory;
+    directory.parent = parent;
+    directory.nameOffset = storeName(name);
+    m_directories.push_back(directory);
+    return static_cast<int>(m_directories.size()) - 1;
+}
+
+PayloadTree::File &PayloadTree::addFile(int directory, const char *name) {
+    File file;
+    file.directory = directory;
+    file.nameOffset = storeName(name);
+    m_files.push_back(file);
+    return m_files.back();
+}
+
+quint32 PayloadTree::storeName(const char *name) {
+    const quint32 offset = static_cast<quint32>(m_names.size());
+    m_names.insert(m_names.end(), name, name + std::strlen(name) + 1);
+    return offset;
+}
+
+QString PayloadTree::relativeDirectoryPath(int directory) const {
+    QStringList parts;
+    for (int index = directory; index > 0; index = m_directories[static_cast<size_t>(index)].parent) {
+        parts.prepend(QFile::decodeName(name(m_directories[static_cast<size_t>(index)].nameOffset)));
+    }
+    return parts.join(QLatin1Char('/'));
+}
+
+QString PayloadTree::relativeFilePath(const File &file) const {
+    const QString directory = relativeDirectoryPath(file.directory);
+    const QString fileNameString = QFile::decodeName(fileName(file));
+    return directory.isEmpty() ? fileNameString : directory + QLatin1Char('/') + fileNameString;
+}
+
+#ifdef Q_OS_LINUX
+
+namespace {
+QString systemError() {
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+bool isDotOrDotDot(const char *name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+}
+
+bool PayloadTree::scan(const QString &root, QString &error) {
+    clear();
+
+    const int fd = ::open(QFile::encodeName(root).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        error = tr("Não foi possível abrir %1: %2").arg(root, systemError());
+        return false;
+    }
+    return scanDirectory(fd, 0, error);
+}
+
+bool PayloadTree::scanDirectory(int fd, int directory, QString &error) {
+    DIR *stream = fdopendir(fd);
+    if (!stream) {
+        error = tr("Não foi possível listar %1: %2").arg(relativeDirectoryPath(directory), systemError());
+        ::close(fd);
+        return false;
+    }
+
+    bool ok = true;
+    while (dirent *entry = readdir(stream)) {
+        const char *entryName = entry->d_name;
+        if (isDotOrDotDot(entryName)) {
+            continue;
+        }
+
+        unsigned char type = entry->d_type;
+        bool followedLink = false;
+        if (type == DT_UNKNOWN || type == DT_LNK) {
+            // Links são seguidos como no QDirIterator; links quebrados são ignorados.
+            struct stat info;
+            if (fstatat(fd, entryName, &info, 0) != 0) {
+                continue;
+            }
+            followedLink = type == DT_LNK;
+            type = S_ISDIR(info.st_mode) ? DT_DIR : (S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN);
+        }
+
+        if (type == DT_DIR) {
+            const int index = addDirectory(directory, entryName);
+            if (followedLink) {
+                // Diretórios apontados por links são criados, mas não percorridos.
+                continue;
+            }
+
+            const int childFd = openat(fd, entryName, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (childFd < 0) {
+                error = tr("Não foi possível abrir %1: %2").arg(relativeDirectoryPath(index), systemError());
+                ok = false;
+                break;
+            }
+            if (!scanDirectory(childFd, index, error)) {
+                ok = false;
+                break;
+            }
+        } else if (type == DT_REG) {
+            addFile(directory, entryName).inode = entry->d_ino;
+        }
+    }
+
+    closedir(stream);
+    return ok;
+}
+
+DirectoryHandleCache::DirectoryHandleCache(const PayloadTree &tree, int rootFd, bool createMissing, int capacity)
+    : m_tree(tree),
+      m_rootFd(rootFd),
+      m_createMissing(createMissing),
+      m_fds(tree.directories().size(), -1),
+      m_created(tree.directories().size(), false),
+      m_openOrder(static_cast<size_t>(std::max(1, capacity)), -1) {
+}
+
+DirectoryHandleCache::~DirectoryHandleCache() {
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+int DirectoryHandleCache::handle(int directory, QString &error) {
+    if (directory == 0) {
+        return m_rootFd;
+    }
+    const size_t index = static_cast<size_t>(directory);
+    if (m_fds[index] >= 0) {
+        return m_fds[index];
+    }
+
+    const PayloadTree::Directory &entry = m_tree.directories()[index];
+    const int parentFd = handle(entry.parent, error);
+    if (parentFd < 0) {
+        return -1;
+    }
+
+    const char *entryName = m_tree.name(entry.nameOffset);
+    if (m_createMissing && !m_created[index]) {
+        if (mkdirat(parentFd, entryName, 0777) != 0 && errno != EEXIST) {
+            error = tr("Não foi possível criar a pasta %1: %2").arg(m_tree.relativeDirectoryPath(directory), systemError());
+            return -1;
+        }
+        m_created[index] = true;
+    }
+
+    const int fd = openat(parentFd, entryName, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        error = tr("Não foi possível abrir a pasta %1: %2").arg(m_tree.relativeDirectoryPath(directory), systemError());
+        return -1;
+    }
+
+    // Evicção FIFO: o descritor mais antigo é fechado e reaberto se voltar a ser usado.
+    const int evicted = m_openOrder[m_nextEviction];
+    if (evicted >= 0) {
+        ::close(m_fds[static_cast<size_t>(evicted)]);
+        m_fds[static_cast<size_t>(evicted)] = -1;
+    }
+    m_openOrder[m_nextEviction] = directory;
+    m_nextEviction = (m_nextEviction + 1) % m_openOrder.size();
+
+    m_fds[index] = fd;
+    return fd;
+}
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,88 @@
+#ifndef PAYLOADTREE_H
+#define PAYLOADTREE_H
+
+#include <QCoreApplication>
+#include <QString>
+
+#include <vector>
+
+// Inventário do pacote. No Linux é obtido com descritores de diretório
+// (openat/fdopendir); para o pacote embutido vem do índice anexado ao
+// executável. Os nomes ficam em uma única área contígua e cada entrada guarda
+// apenas índices, de modo que percorrer e copiar a árvore não reconstrói
+// caminhos nem aloca memória por arquivo.
+class PayloadTree {
+    Q_DECLARE_TR_FUNCTIONS(PayloadTree)
+public:
+    struct Directory {
+        int parent = -1;
+        quint32 nameOffset = 0;
+    };
+
+    struct File {
+        int directory = 0;
+        quint32 nameOffset = 0;
+        quint64 inode = 0;
+        // Preenchidos apenas para o pacote embutido.
+        quint64 dataOffset = 0;
+        qint64 size = -1;
+        quint32 mode = 0;
+    };
+
+#ifdef Q_OS_LINUX
+    bool scan(const QString &root, QString &error);
+#endif
+
+    void clear();
+    int addDirectory(int parent, const char *name);
+    File &addFile(int directory, const char *name);
+
+    const std::vector<Directory> &directories() const { return m_directories; }
+    const std::vector<File> &files() const { return m_files; }
+
+    const char *name(quint32 offset) const { return m_names.data() + offset; }
+    const char *fileName(const File &file) const { return name(file.nameOffset); }
+
+    // Caminhos completos são montados apenas para mensagens ao usuário.
+    QString relativeDirectoryPath(int directory) const;
+    QString relativeFilePath(const File &file) const;
+
+private:
+#ifdef Q_OS_LINUX
+    bool scanDirectory(int fd, int directory, QString &error);
+#endif
+    quint32 storeName(const char *name);
+
+    std::vector<Directory> m_directories;
+    std::vector<File> m_files;
+    std::vector<char> m_names;
+};
+
+#ifdef Q_OS_LINUX
+
+// Cache limitado de descritores de diretório indexado pelo PayloadTree.
+// No destino, cada diretório é criado com mkdirat uma única vez por instalação.
+class DirectoryHandleCache {
+    Q_DECLARE_TR_FUNCTIONS(DirectoryHandleCache)
+public:
+    DirectoryHandleCache(const PayloadTree &tree, int rootFd, bool createMissing, int capacity = 128);
+    ~DirectoryHandleCache();
+
+    DirectoryHandleCache(const DirectoryHandleCache &) = delete;
+    DirectoryHandleCache &operator=(const DirectoryHandleCache &) = delete;
+
+    int handle(int directory, QString &error);
+
+private:
+    const PayloadTree &m_tree;
+    const int m_rootFd;
+    const bool m_createMissing;
+    std::vector<int> m_fds;
+    std::vector<bool> m_created;
+    std::vector<int> m_openOrder;
+    size_t m_nextEviction = 0;
+};
+
+#endif // Q_OS_LINUX
+
+#endif // PAYLOADTREE_H
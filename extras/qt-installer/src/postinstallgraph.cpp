@@ -0,0 +1,222 @@
+#include "postinstallgraph.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <utility>
+
+PostInstallGraph::PostInstallGraph() {
+    m_pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount()));
+}
+
+PostInstallGraph::~PostInstallGraph() {
+    m_pool.waitForDone();
+}
+
+void PostInstallGraph::addMilestone(const QString &name) {
+    QMutexLocker locker(&m_mutex);
+    Q_ASSERT(!m_started);
+    if (m_index.contains(name)) {
+        return;
+    }
+    Node node;
+    node.name = name;
+    node.milestone = true;
+    m_index.insert(name, static_cast<int>(m_nodes.size()));
+    m_nodes.push_back(std::move(node));
+}
+
+void PostInstallGraph::addTask(const QString &name, const QStringList &dependencies, Task task) {
+    QMutexLocker locker(&m_mutex);
+    Q_ASSERT(!m_started);
+    Node node;
+    node.name = name;
+    node.dependencies = dependencies;
+    node.task = std::move(task);
+    m_index.insert(name, static_cast<int>(m_nodes.size()));
+    m_nodes.push_back(std::move(node));
+}
+
+void PostInstallGraph::setProgressHandler(ProgressHandler handler) {
+    m_progressHandler = std::move(handler);
+}
+
+void PostInstallGraph::start() {
+    QMutexLocker locker(&m_mutex);
+    m_started = true;
+    m_timer.start();
+    scheduleLocked();
+}
+
+void PostInstallGraph::complete(const QString &milestone, bool success, const QString &error) {
+    QMutexLocker locker(&m_mutex);
+    const auto found = m_index.constFind(milestone);
+    if (found == m_index.constEnd()) {
+        return;
+    }
+    Node &node = m_nodes[static_cast<size_t>(*found)];
+    if (node.milestone && node.state == State::Pending) {
+        completeLocked(node, success, error);
+        scheduleLocked();
+        m_changed.wakeAll();
+    }
+}
+
+void PostInstallGraph::completeMilestones(bool success, const QString &error) {
+    QMutexLocker locker(&m_mutex);
+    m_tailStartMs = m_timer.isValid() ? m_timer.elapsed() : 0;
+    for (Node &node : m_nodes) {
+        if (node.milestone && node.state == State::Pending) {
+            completeLocked(node, success, error);
+        }
+    }
+    scheduleLocked();
+    m_changed.wakeAll();
+}
+
+bool PostInstallGraph::waitForFinished() {
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        const bool pendingTasks = std::any_of(m_nodes.cbegin(), m_nodes.cend(), [](const Node &node) {
+            return !node.milestone && node.state == State::Pending;
+        });
+        if (m_running == 0 && !pendingTasks) {
+            break;
+        }
+        const bool pendingMilestones = std::any_of(m_nodes.cbegin(), m_nodes.cend(), [](const Node &node) {
+            return node.milestone && node.state == State::Pending;
+        });
+        if (m_running == 0 && !pendingMilestones) {
+            // Nada mais pode liberar as tarefas restantes: dependência circular.
+            for (Node &node : m_nodes) {
+                if (!node.milestone && node.state == State::Pending) {
+                    node.state = State::Skipped;
+                    node.message = tr("Ignorada: dependência circular");
+                }
+            }
+            break;
+        }
+        m_changed.wait(&m_mutex);
+    }
+    m_finishedMs = m_timer.elapsed();
+    return std::none_of(m_nodes.cbegin(), m_nodes.cend(), [](const Node &node) {
+        return !node.milestone && node.state != State::Succeeded;
+    });
+}
+
+QList<PostInstallGraph::Result> PostInstallGraph::results() const {
+    QMutexLocker locker(&m_mutex);
+    QList<Result> results;
+    for (const Node &node : m_nodes) {
+        if (node.milestone) {
+            continue;
+        }
+        Result result;
+        result.name = node.name;
+        result.success = node.state == State::Succeeded;
+        result.skipped = node.state == State::Skipped;
+        result.message = node.message;
+        result.elapsedMs = node.elapsedMs;
+        results.append(result);
+    }
+    return results;
+}
+
+qint64 PostInstallGraph::tailMs() const {
+    QMutexLocker locker(&m_mutex);
+    return m_finishedMs - std::max<qint64>(m_tailStartMs, 0);
+}
+
+qint64 PostInstallGraph::totalTaskMs() const {
+    QMutexLocker locker(&m_mutex);
+    qint64 total = 0;
+    for (const Node &node : m_nodes) {
+        total += node.elapsedMs;
+    }
+    return total;
+}
+
+void PostInstallGraph::completeLocked(Node &node, bool success, const QString &error) {
+    node.state = success ? State::Succeeded : State::Failed;
+    node.message = error;
+}
+
+void PostInstallGraph::scheduleLocked() {
+    if (!m_started) {
+        return;
+    }
+
+    // Repete até estabilizar para propagar dependências ignoradas em cadeia.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t index = 0; index < m_nodes.size(); ++index) {
+            Node &node = m_nodes[index];
+            if (node.milestone || node.state != State::Pending) {
+                continue;
+            }
+
+            bool ready = true;
+            for (const QString &dependency : std::as_const(node.dependencies)) {
+                const auto found = m_index.constFind(dependency);
+                if (found == m_index.constEnd()) {
+                    node.state = State::Skipped;
+                    node.message = tr("Ignorada: dependência desconhecida %1").arg(dependency);
+                    break;
+                }
+                const Node &required = m_nodes[static_cast<size_t>(*found)];
+                if (required.state == State::Failed || required.state == State::Skipped) {
+                    node.state = State::Skipped;
+                    node.message = required.message.isEmpty() ? tr("Ignorada: %1 falhou").arg(required.name)
+                                                              : tr("Ignorada: %1 falhou (%2)").arg(required.name, required.message);
+                    break;
+                }
+                ready = ready && required.state == State::Succeeded;
+            }
+
+            if (node.state == State::Skipped) {
+                changed = true;
+            } else if (ready) {
+                node.state = State::Running;
+                ++m_running;
+                const int taskIndex = static_cast<int>(index);
+                m_pool.start([this, taskIndex]() { run(taskIndex); });
+            }
+        }
+    }
+}
+
+void PostInstallGraph::run(int index) {
+    QString name;
+    Task task;
+    {
+        QMutexLocker locker(&m_mutex);
+        const Node &node = m_nodes[static_cast<size_t>(index)];
+        name = node.name;
+        task = node.task;
+    }
+
+    const Reporter report = [this, name](int progressValue) {
+        if (m_progressHandler) {
+            m_progressHandler(name, progressValue);
+        }
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    report(0);
+    QString error;
+    const bool success = task(report, error);
+    if (success) {
+        report(100);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Node &node = m_nodes[static_cast<size_t>(index)];
+    node.elapsedMs = timer.elapsed();
+    completeLocked(node, success, error);
+    --m_running;
+    scheduleLocked();
+    m_changed.wakeAll();
+}
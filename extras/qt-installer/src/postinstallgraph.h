@@ -0,0 +1,99 @@
+#ifndef POSTINSTALLGRAPH_H
+#define POSTINSTALLGRAPH_H
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <functional>
+#include <vector>
+
+// Agendador das etapas que seguem a cópia (estado, atalhos, verificações...).
+// Cada tarefa declara de quais outras tarefas ou marcos depende e roda no
+// próprio pool assim que todas as dependências terminam com sucesso; tarefas
+// independentes rodam em paralelo e o fim da instalação passa a custar a
+// tarefa mais longa, não a soma de todas.
+//
+// Marcos são dependências sem código, concluídos de fora por complete().
+class PostInstallGraph {
+    Q_DECLARE_TR_FUNCTIONS(PostInstallGraph)
+public:
+    using Reporter = std::function<void(int progressValue)>;
+    using Task = std::function<bool(const Reporter &report, QString &error)>;
+    using ProgressHandler = std::function<void(const QString &task, int progressValue)>;
+
+    struct Result {
+        QString name;
+        bool success = false;
+        bool skipped = false;
+        QString message;
+        qint64 elapsedMs = 0;
+    };
+
+    PostInstallGraph();
+    ~PostInstallGraph();
+
+    PostInstallGraph(const PostInstallGraph &) = delete;
+    PostInstallGraph &operator=(const PostInstallGraph &) = delete;
+
+    void addMilestone(const QString &name);
+    void addTask(const QString &name, const QStringList &dependencies, Task task);
+    void setProgressHandler(ProgressHandler handler);
+
+    void start();
+    void complete(const QString &milestone, bool success, const QString &error = QString());
+    // Conclui todos os marcos ainda pendentes com o resultado final da cópia.
+    void completeMilestones(bool success, const QString &error = QString());
+
+    // Bloqueia até todas as tarefas terminarem; retorna true se nenhuma falhou.
+    bool waitForFinished();
+    QList<Result> results() const;
+    // Tempo entre completeMilestones() e o fim da última tarefa, e a soma do
+    // tempo de todas as tarefas, para comparar com a execução sequencial.
+    qint64 tailMs() const;
+    qint64 totalTaskMs() const;
+
+private:
+    enum class State {
+        Pending,
+        Running,
+        Succeeded,
+        Failed,
+        Skipped
+    };
+
+    struct Node {
+        QString name;
+        QStringList dependencies;
+        Task task;
+        bool milestone = false;
+        State state = State::Pending;
+        QString message;
+        qint64 elapsedMs = 0;
+    };
+
+    void completeLocked(Node &node, bool success, const QString &error);
+    void scheduleLocked();
+    void run(int index);
+
+    std::vector<Node> m_nodes;
+    QHash<QString, int> m_index;
+    ProgressHandler m_progressHandler;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_changed;
+    QThreadPool m_pool;
+    QElapsedTimer m_timer;
+    bool m_started = false;
+    int m_running = 0;
+    qint64 m_tailStartMs = -1;
+    qint64 m_finishedMs = 0;
+};
+
+#endif // POSTINSTALLGRAPH_H